@@ -0,0 +1,188 @@
+/** @file
+ * nanojson: A Simple JSON Reader/Writer For C++17
+ * Copyright (c) 2016-2023 ttsuki
+ * This software is released under the MIT License.
+ */
+
+// Parser throughput benchmark.
+// Build with optimization (e.g. `cmake -DCMAKE_BUILD_TYPE=Release`) and run `nanojson3_benchmark [record count]`.
+
+#define NANOJSON3_USE_MMAP // `parse_json_file` maps the file
+#include "nanojson3.h"
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <functional>
+#include <optional>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+// makes a test document: an array of log-like records
+static njs3::json make_document(size_t count)
+{
+    njs3::js_array records;
+    records.reserve(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto n = static_cast<njs3::js_integer>(i);
+        records.emplace_back(njs3::js_object{
+            {"id", n},
+            {"timestamp", 1690000000 + n},
+            {"name", "user" + std::to_string(i)},
+            {"score", static_cast<double>(i % 1000) / 7.0},
+            {"active", i % 3 == 0},
+            {"tags", njs3::js_array{"alpha", "beta", "gamma"}},
+            {"note", std::string(i % 4 * 24, 'x') + "\"quoted\" \\ path/to"},
+            {"nested", njs3::js_object{{"a", nullptr}, {"b", njs3::js_array{1, 2, 3}}}},
+        });
+    }
+    return records;
+}
+
+// makes a test document: an array of long text fields and base64-like blobs
+static njs3::json make_string_document(size_t count)
+{
+    constexpr char base64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    njs3::js_array records;
+    records.reserve(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        std::string blob(1024, '=');
+        for (size_t j = 0; j < blob.size() - 2; j++) blob[j] = base64[(i * 31 + j * 7) % 64];
+        records.emplace_back(njs3::js_object{
+            {"text", "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.\n"},
+            {"blob", blob},
+        });
+    }
+    return records;
+}
+
+// the record of `make_document`, read by `parse_into`
+struct bench_record
+{
+    struct nested_type
+    {
+        std::optional<int> a{};
+        std::vector<int> b{};
+        static constexpr auto json_fields = std::make_tuple(njs3::json_field("a", &nested_type::a), njs3::json_field("b", &nested_type::b));
+    };
+
+    int64_t id{};
+    int64_t timestamp{};
+    std::string name{};
+    double score{};
+    bool active{};
+    std::vector<std::string> tags{};
+    std::string note{};
+    nested_type nested{};
+
+    static constexpr auto json_fields = std::make_tuple(
+        njs3::json_field("id", &bench_record::id), njs3::json_field("timestamp", &bench_record::timestamp), njs3::json_field("name", &bench_record::name),
+        njs3::json_field("score", &bench_record::score), njs3::json_field("active", &bench_record::active), njs3::json_field("tags", &bench_record::tags),
+        njs3::json_field("note", &bench_record::note), njs3::json_field("nested", &bench_record::nested));
+};
+
+// measures the best throughput of `f` over `source`
+static void measure(const char* name, const std::string& source, const std::function<void(const std::string&)>& f)
+{
+    double best = 1e100;
+    for (int i = 0; i < 5; i++)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        f(source);
+        const auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(t1 - t0).count());
+    }
+
+    std::cout << std::left << std::setw(32) << name
+        << std::right << std::setw(10) << source.size() / 1024 << " KiB"
+        << std::setw(10) << std::fixed << std::setprecision(1) << static_cast<double>(source.size()) / best / 1e6 << " MB/s\n";
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t count = argc > 1 ? std::stoul(argv[1]) : 50000;
+    const njs3::json document = make_document(count);
+    const std::string minified = document.serialize(njs3::json_serialize_option::none);
+    const std::string pretty = document.serialize(njs3::json_serialize_option::pretty);
+
+    measure("parse_json (minified)", minified, [](const std::string& s) { (void)njs3::parse_json(s); });
+    measure("parse_json (pretty)", pretty, [](const std::string& s) { (void)njs3::parse_json(s); });
+    measure("parse_json (validate_utf8)", minified, [](const std::string& s) { (void)njs3::parse_json(s, njs3::json_parse_option::default_option | njs3::json_parse_option::validate_utf8); });
+    measure("parse_json (raw number)", minified, [](const std::string& s) { (void)njs3::parse_json(s, njs3::json_parse_option::raw_number); });
+    measure("parse_json_indexed (minified)", minified, [](const std::string& s) { (void)njs3::parse_json_indexed(s); });
+    measure("parse_json_indexed (pretty)", pretty, [](const std::string& s) { (void)njs3::parse_json_indexed(s); });
+    measure("parse_json_parallel (1 thread)", minified, [](const std::string& s) { (void)njs3::parse_json_parallel(s, njs3::json_parse_option::default_option, 1); });
+    measure("parse_json_parallel (all)", minified, [](const std::string& s) { (void)njs3::parse_json_parallel(s); });
+    measure("parse_json_view (minified)", minified, [](const std::string& s) { (void)njs3::parse_json_view(s); });
+    measure("parse_json_view (raw number)", minified, [](const std::string& s) { (void)njs3::parse_json_view(s, njs3::json_parse_option::raw_number); });
+    measure("parse_json_document (minified)", minified, [](const std::string& s) { (void)njs3::parse_json_document(s); });
+    measure("parse_json_tape (minified)", minified, [](const std::string& s) { (void)njs3::parse_json_tape(s); });
+    measure("parse_json_events (minified)", minified, [](const std::string& s) { njs3::json_event_handler h{}; njs3::parse_json_events(s, h); });
+    measure("json_cursor (skip, minified)", minified, [](const std::string& s) { njs3::json_cursor(s).skip_value(); });
+    measure("parse_json_paths (2 fields)", minified, [](const std::string& s) { (void)njs3::parse_json_paths(s, {"/0/id", "/100/nested/b"}); });
+    measure("parse_json_lazy (1 record)", minified, [](const std::string& s) { (void)njs3::parse_json_lazy(s)[100]["nested"]["b"][1].get_integer(); });
+    measure("parse_into (structs)", minified, [](const std::string& s) { (void)njs3::parse_into<std::vector<bench_record>>(s); });
+    measure("json_push_parser (1460B chunks)", minified, [](const std::string& s)
+    {
+        njs3::json_push_parser parser{};
+        for (size_t i = 0; i < s.size(); i += 1460) parser.feed(std::string_view(s).substr(i, 1460));
+        parser.finish();
+        (void)parser.result();
+    });
+    measure("parse_json (pretty, comment)", pretty, [](const std::string& s) { (void)njs3::parse_json(s, njs3::json_parse_option::allow_comment); });
+
+    std::string lines;
+    for (auto&& record : *document.as_array()) lines += record.serialize() + '\n';
+    measure("parse_json_lines (1 thread)", lines, [](const std::string& s) { (void)njs3::parse_json_lines(s, njs3::json_parse_option::default_option, 1); });
+    measure("parse_json_lines (all threads)", lines, [](const std::string& s) { (void)njs3::parse_json_lines(s); });
+    measure("parse_json (each line)", lines, [](const std::string& s)
+    {
+        for (size_t i = 0, eol; i < s.size(); i = eol + 1)
+            eol = s.find('\n', i), (void)njs3::parse_json(std::string_view(s).substr(i, eol - i));
+    });
+    measure("json_parser::parse_into (line)", lines, [](const std::string& s)
+    {
+        njs3::json_parser parser{};
+        njs3::json record{};
+        for (size_t i = 0, eol; i < s.size(); i = eol + 1)
+            eol = s.find('\n', i), parser.parse_into(std::string_view(s).substr(i, eol - i), record);
+    });
+
+    const char* file = "nanojson3_benchmark.json";
+    std::ofstream(file, std::ios::binary) << minified;
+    measure("parse_json_file (minified)", minified, [&](const std::string&) { (void)njs3::parse_json_file(file); });
+    measure("ifstream >> json (minified)", minified, [&](const std::string&)
+    {
+        std::ifstream stream(file, std::ios::binary);
+        njs3::json json{};
+        stream >> json;
+    });
+    std::remove(file);
+    measure("istringstream >> json (minified)", minified, [](const std::string& s)
+    {
+        std::istringstream stream(s);
+        njs3::json json{};
+        stream >> json;
+    });
+
+    njs3::js_object map;
+    for (size_t i = 0; i < count; i++) map.append_unchecked(njs3::json::js_object_kvp("id" + std::to_string(i), static_cast<njs3::js_integer>(i)));
+    measure("parse_json (keyed map)", njs3::json(std::move(map)).serialize(), [](const std::string& s) { (void)njs3::parse_json(s); });
+
+    measure("serialize (minified)", minified, [&](const std::string&) { (void)document.serialize(); });
+    measure("ostringstream << json (minified)", minified, [&](const std::string&)
+    {
+        std::ostringstream stream;
+        stream << njs3::json_out_minify << document;
+    });
+    measure("serialize (shortest floating)", minified, [&](const std::string&) { (void)document.serialize(njs3::json_serialize_option::none, {std::chars_format::general, -1}); });
+
+    const std::string strings = make_string_document(count / 4).serialize();
+    measure("parse_json (long strings)", strings, [](const std::string& s) { (void)njs3::parse_json(s); });
+    measure("parse_json (long strings, utf8)", strings, [](const std::string& s) { (void)njs3::parse_json(s, njs3::json_parse_option::default_option | njs3::json_parse_option::validate_utf8); });
+}
@@ -12,8 +12,10 @@
 #define NANOJSON3_H_INCLUDED
 
 #include <cstddef>
+#include <cstdint>
 #include <cassert>
 #include <cmath>
+#include <cstring>
 
 #include <type_traits>
 #include <limits>
@@ -21,6 +23,7 @@
 #include <algorithm>
 #include <stdexcept>
 #include <memory>
+#include <functional>
 
 #include <variant>
 #include <optional>
@@ -34,14 +37,70 @@
 
 #include <istream>
 #include <ostream>
+#include <fstream>
 #include <iomanip>
 #include <charconv>
 #include <sstream>
 
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <system_error>
+#include <cerrno>
+
 #if !((defined(__cplusplus) && __cplusplus >= 201703L) || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L))
 #error "nanojson needs C++17 support."
 #endif
 
+// NANOJSON3_TRACK_SOURCE_LINE: if nonzero, the reader tracks line numbers while reading single-pass input (such as `std::istreambuf_iterator`)
+// to report line/column in bad_format. Multi-pass input is rescanned when an error is raised, so it never needs this.
+#ifndef NANOJSON3_TRACK_SOURCE_LINE
+#ifdef NDEBUG
+#define NANOJSON3_TRACK_SOURCE_LINE 0
+#else
+#define NANOJSON3_TRACK_SOURCE_LINE 1
+#endif
+#endif
+
+// NANOJSON3_MAX_DEPTH: default max nesting depth of arrays and objects the reader accepts.
+// Deeper input is rejected with bad_format (the reader itself does not recurse, but deep trees are expensive to build and destroy).
+#ifndef NANOJSON3_MAX_DEPTH
+#define NANOJSON3_MAX_DEPTH 1024
+#endif
+
+// NANOJSON3_FLOATING_TYPE: the type storing floating numbers (`json::js_floating`).
+// `double` makes values smaller and reading/writing faster, but numbers beyond its range or precision are rounded.
+#ifndef NANOJSON3_FLOATING_TYPE
+#define NANOJSON3_FLOATING_TYPE long double
+#endif
+
+// NANOJSON3_NO_SIMD: if defined, the reader uses scalar code only.
+// Otherwise, the reader uses SSE2/AVX2 instructions for contiguous input if the compiler targets them.
+#if !defined(NANOJSON3_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define NANOJSON3_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+#if !defined(NANOJSON3_NO_SIMD) && defined(__AVX2__)
+#define NANOJSON3_SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// NANOJSON3_USE_MMAP: if defined, `json_mapped_file` (used by `parse_json_file`) maps files with POSIX `mmap` if available
+// (then this header includes <sys/mman.h>, <sys/stat.h>, <fcntl.h> and <unistd.h>). Otherwise, it reads files into memory.
+#if defined(NANOJSON3_USE_MMAP) && defined(__has_include)
+#if __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#define NANOJSON3_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#endif
+
 #if !(defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L)
 #pragma message("nanojson needs C++17 Elementary string conversions (P0067R5) including Floating-Point (FP) values support. See (https://en.cppreference.com/w/cpp/compiler_support/17#:~:text=Elementary%20string%20conversions) This time, falling back to an implementation with stringstream instead.")
 #endif
@@ -168,6 +227,7 @@ namespace nanojson3
             template <class InputIterator> void insert(InputIterator first, InputIterator last) { for (auto it = first; it != last; ++it) this->insert(*it); }
             void insert(std::initializer_list<pair_type> init) { this->insert(init.begin(), init.end()); }
             template <class... Args> ENABLE_IF<std::pair<iterator, bool>, pair_is_constructible_from<Args...>> emplace(Args&&... args) { return operate_insert(pair_type(std::forward<args>(args)...)); }
+            template <class Pair> ENABLE_IF<void, pair_is_constructible_from<Pair>> append_unchecked(Pair&& p) { base_container::emplace_back(std::forward<Pair>(p)); } // appends without looking up the key (the caller ensures it is unique)
             template <class Value> ENABLE_IF<std::pair<iterator, bool>, value_is_constructible_from<Value>> insert_or_assign(const key_type& key, Value&& val) { return operate_emplace<or_assign>(std::forward<decltype(key)>(key), std::forward<decltype(val)>(val)); }
             template <class Value> ENABLE_IF<std::pair<iterator, bool>, value_is_constructible_from<Value>> insert_or_assign(key_type&& key, Value&& val) { return operate_emplace<or_assign>(std::forward<decltype(key)>(key), std::forward<decltype(val)>(val)); }
             template <class... VArgs> ENABLE_IF<std::pair<iterator, bool>, value_is_constructible_from<VArgs...>> try_emplace(const key_type& k, VArgs&&... args) { return operate_emplace(std::forward<decltype(k)>(k), std::forward<decltype(args)>(args)...); }
@@ -260,6 +320,639 @@ namespace nanojson3
                 return 0;
             }
         };
+
+        // character scanning functions for contiguous input
+        namespace scan
+        {
+            // locale-independent is_space
+            [[nodiscard]] constexpr bool is_space(char c) noexcept { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+            // counts trailing zero bits (`bits` must not be zero)
+            [[nodiscard]] inline int count_trailing_zeros(uint32_t bits) noexcept
+            {
+                assert(bits != 0);
+#if defined(_MSC_VER) && !defined(__clang__)
+                unsigned long index{};
+                _BitScanForward(&index, bits);
+                return static_cast<int>(index);
+#else
+                return __builtin_ctz(bits);
+#endif
+            }
+
+            // counts trailing zero bits (`bits` must not be zero)
+            [[nodiscard]] inline int count_trailing_zeros(uint64_t bits) noexcept
+            {
+                assert(bits != 0);
+#if defined(_MSC_VER) && !defined(__clang__)
+                const auto low = static_cast<uint32_t>(bits);
+                return low ? count_trailing_zeros(low) : 32 + count_trailing_zeros(static_cast<uint32_t>(bits >> 32));
+#else
+                return __builtin_ctzll(bits);
+#endif
+            }
+
+#if NANOJSON3_SIMD_SSE2
+            // makes bit mask of white spaces in 16 bytes at `p`
+            [[nodiscard]] inline uint32_t whitespace_mask16(const char* p) noexcept
+            {
+                const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                const __m128i sp = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(x, _mm_set1_epi8('\t')));
+                const __m128i nl = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(x, _mm_set1_epi8('\r')));
+                return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(sp, nl)));
+            }
+#endif
+
+#if NANOJSON3_SIMD_AVX2
+            // makes bit mask of white spaces in 32 bytes at `p`
+            [[nodiscard]] inline uint32_t whitespace_mask32(const char* p) noexcept
+            {
+                const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                const __m256i sp = _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\t')));
+                const __m256i nl = _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\r')));
+                return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(sp, nl)));
+            }
+#endif
+
+            // skips white spaces in `[p, end)`, returns pointer to the first non-space character or `end`
+            [[nodiscard]] inline const char* skip_whitespaces(const char* p, const char* end) noexcept
+            {
+                // most runs are short (none in minified text, or a line break and an indent), so tries a few characters first.
+                for (int i = 0; i < 4; i++, ++p)
+                    if (p == end || !is_space(*p)) return p;
+
+#if NANOJSON3_SIMD_AVX2
+                for (; end - p >= 32; p += 32)
+                    if (const uint32_t m = ~whitespace_mask32(p)) return p + count_trailing_zeros(m);
+#endif
+#if NANOJSON3_SIMD_SSE2
+                for (; end - p >= 16; p += 16)
+                    if (const uint32_t m = ~whitespace_mask16(p) & 0xFFFF) return p + count_trailing_zeros(m);
+#endif
+                while (p != end && is_space(*p)) ++p;
+                return p;
+            }
+
+#if NANOJSON3_SIMD_SSE2
+            // makes bit mask of characters which needs special treatment in a string literal in 16 bytes at `p`
+            // (and non-ASCII bytes, masked by `non_ascii_mask`)
+            [[nodiscard]] inline uint32_t string_special_mask16(const char* p, char slash, uint32_t non_ascii_mask) noexcept
+            {
+                const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                const __m128i ctrl = _mm_cmpeq_epi8(_mm_min_epu8(x, _mm_set1_epi8(0x1F)), x); // x <= 0x1F
+                const __m128i quote = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('"')), _mm_cmpeq_epi8(x, _mm_set1_epi8('\\')));
+                const __m128i other = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(0x7F)), _mm_cmpeq_epi8(x, _mm_set1_epi8(slash)));
+                return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(ctrl, _mm_or_si128(quote, other)))) | (static_cast<uint32_t>(_mm_movemask_epi8(x)) & non_ascii_mask);
+            }
+#endif
+
+#if NANOJSON3_SIMD_AVX2
+            // makes bit mask of characters which needs special treatment in a string literal in 32 bytes at `p`
+            // (and non-ASCII bytes, masked by `non_ascii_mask`)
+            [[nodiscard]] inline uint32_t string_special_mask32(const char* p, char slash, uint32_t non_ascii_mask) noexcept
+            {
+                const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                const __m256i ctrl = _mm256_cmpeq_epi8(_mm256_min_epu8(x, _mm256_set1_epi8(0x1F)), x); // x <= 0x1F
+                const __m256i quote = _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('"')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\\')));
+                const __m256i other = _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(0x7F)), _mm256_cmpeq_epi8(x, _mm256_set1_epi8(slash)));
+                return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(ctrl, _mm256_or_si256(quote, other)))) | (static_cast<uint32_t>(_mm256_movemask_epi8(x)) & non_ascii_mask);
+            }
+#endif
+
+            // finds a character which needs special treatment in a string literal:
+            // `"`, `\`, control characters, DEL, `/` if `escaped_slash` is true, and non-ASCII bytes if `non_ascii` is true.
+            // returns pointer to it or `end`
+            [[nodiscard]] inline const char* find_string_special(const char* p, const char* end, bool escaped_slash, bool non_ascii = false) noexcept
+            {
+                const char slash = escaped_slash ? '/' : '"';
+                [[maybe_unused]] const uint32_t non_ascii_mask = non_ascii ? ~uint32_t{} : 0;
+
+#if NANOJSON3_SIMD_AVX2
+                for (; end - p >= 32; p += 32)
+                    if (const uint32_t m = string_special_mask32(p, slash, non_ascii_mask)) return p + count_trailing_zeros(m);
+#endif
+#if NANOJSON3_SIMD_SSE2
+                for (; end - p >= 16; p += 16)
+                    if (const uint32_t m = string_special_mask16(p, slash, non_ascii_mask)) return p + count_trailing_zeros(m);
+#endif
+                for (; p != end; ++p)
+                {
+                    const auto c = static_cast<unsigned char>(*p);
+                    if (c < 0x20 || c == '"' || c == '\\' || c == 0x7F || c == slash || (c >= 0x80 && non_ascii)) return p;
+                }
+                return end;
+            }
+
+            // the rule of a UTF-8 sequence starting with `lead` byte (RFC 3629): its length (0 if `lead` can't start a sequence),
+            // and the range of the second byte (which excludes overlong forms, surrogates and code points beyond U+10FFFF).
+            struct utf8_sequence_rule
+            {
+                int length;
+                unsigned char second_min;
+                unsigned char second_max;
+            };
+
+            [[nodiscard]] inline constexpr utf8_sequence_rule utf8_rule(unsigned char lead) noexcept
+            {
+                if (lead >= 0xC2 && lead <= 0xDF) return {2, 0x80, 0xBF};
+                if (lead >= 0xE0 && lead <= 0xEF) return {3, static_cast<unsigned char>(lead == 0xE0 ? 0xA0 : 0x80), static_cast<unsigned char>(lead == 0xED ? 0x9F : 0xBF)};
+                if (lead >= 0xF0 && lead <= 0xF4) return {4, static_cast<unsigned char>(lead == 0xF0 ? 0x90 : 0x80), static_cast<unsigned char>(lead == 0xF4 ? 0x8F : 0xBF)};
+                return {0, 0, 0};
+            }
+
+            // skips valid UTF-8 sequences of non-ASCII characters from `p`.
+            // returns pointer to the next ASCII character (or `end`), or to the first byte of an invalid (or truncated) sequence.
+            [[nodiscard]] inline const char* skip_utf8_sequences(const char* p, const char* end) noexcept
+            {
+                while (p != end && static_cast<unsigned char>(*p) >= 0x80)
+                {
+                    const auto [length, second_min, second_max] = utf8_rule(static_cast<unsigned char>(*p));
+                    if (length == 0 || end - p < length) return p;
+                    if (static_cast<unsigned char>(p[1]) < second_min || static_cast<unsigned char>(p[1]) > second_max) return p;
+                    for (int i = 2; i < length; i++)
+                        if ((static_cast<unsigned char>(p[i]) & 0xC0) != 0x80) return p;
+                    p += length;
+                }
+                return p;
+            }
+
+            // finds `c` in `[p, end)`, returns pointer to it or `end`
+            [[nodiscard]] inline const char* find(const char* p, const char* end, char c) noexcept
+            {
+                const char* r = std::char_traits<char>::find(p, static_cast<size_t>(end - p), c);
+                return r ? r : end;
+            }
+
+            // skips block comment body until `*/`, returns pointer to the next of `*/` or `end`
+            [[nodiscard]] inline const char* skip_block_comment(const char* p, const char* end) noexcept
+            {
+                while ((p = find(p, end, '*')) != end)
+                    if (++p != end && *p == '/') return p + 1;
+                return end;
+            }
+
+            // skips line comment body until `\n`, returns pointer to the next of `\n` or `end`
+            [[nodiscard]] inline const char* skip_line_comment(const char* p, const char* end) noexcept
+            {
+                p = find(p, end, '\n');
+                return p != end ? p + 1 : end;
+            }
+
+            // character classes in 64 bytes, one bit per byte
+            struct block_masks
+            {
+                uint64_t whitespaces{};
+                uint64_t operators{}; // `{}[]:,`
+                uint64_t quotes{};
+                uint64_t backslashes{};
+            };
+
+            // classifies characters in 64 bytes at `p`
+            [[nodiscard]] inline block_masks classify_block(const char* p) noexcept
+            {
+                block_masks r{};
+#if NANOJSON3_SIMD_AVX2
+                for (int i = 0; i < 64; i += 32)
+                {
+                    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+                    const __m256i folded = _mm256_or_si256(x, _mm256_set1_epi8(0x20)); // `[`, `]` -> `{`, `}`
+                    const __m256i brackets = _mm256_or_si256(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}')));
+                    const __m256i separators = _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8(',')));
+                    r.whitespaces |= static_cast<uint64_t>(whitespace_mask32(p + i)) << i;
+                    r.operators |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(brackets, separators)))) << i;
+                    r.quotes |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('"'))))) << i;
+                    r.backslashes |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('\\'))))) << i;
+                }
+#elif NANOJSON3_SIMD_SSE2
+                for (int i = 0; i < 64; i += 16)
+                {
+                    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+                    const __m128i folded = _mm_or_si128(x, _mm_set1_epi8(0x20)); // `[`, `]` -> `{`, `}`
+                    const __m128i brackets = _mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')), _mm_cmpeq_epi8(folded, _mm_set1_epi8('}')));
+                    const __m128i separators = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(':')), _mm_cmpeq_epi8(x, _mm_set1_epi8(',')));
+                    r.whitespaces |= static_cast<uint64_t>(whitespace_mask16(p + i)) << i;
+                    r.operators |= static_cast<uint64_t>(_mm_movemask_epi8(_mm_or_si128(brackets, separators))) << i;
+                    r.quotes |= static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8('"')))) << i;
+                    r.backslashes |= static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8('\\')))) << i;
+                }
+#else
+                for (int i = 0; i < 64; i++)
+                {
+                    const char c = p[i];
+                    const uint64_t bit = uint64_t{1} << i;
+                    if (is_space(c)) r.whitespaces |= bit;
+                    else if (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',') r.operators |= bit;
+                    else if (c == '"') r.quotes |= bit;
+                    else if (c == '\\') r.backslashes |= bit;
+                }
+#endif
+                return r;
+            }
+
+            // finds characters escaped by backslashes.
+            // `carry` is true if the previous block ended with a backslash escaping the first character of this block.
+            [[nodiscard]] inline uint64_t escaped_mask(uint64_t backslashes, bool& carry) noexcept
+            {
+                uint64_t escaped = carry ? 1 : 0;
+                backslashes &= ~escaped; // an escaped backslash escapes nothing
+                carry = false;
+                while (backslashes) // backslashes are rare, so simply walks them
+                {
+                    const int i = count_trailing_zeros(backslashes);
+                    if (i == 63)
+                    {
+                        carry = true;
+                        break;
+                    }
+                    escaped |= uint64_t{2} << i;
+                    backslashes &= ~(uint64_t{3} << i);
+                }
+                return escaped;
+            }
+
+            // turns each bit on if odd number of bits are on at or below it
+            [[nodiscard]] constexpr uint64_t prefix_xor(uint64_t x) noexcept
+            {
+                x ^= x << 1;
+                x ^= x << 2;
+                x ^= x << 4;
+                x ^= x << 8;
+                x ^= x << 16;
+                x ^= x << 32;
+                return x;
+            }
+
+            // scans json text by 64 bytes, finding structural characters out of strings.
+            class structural_scanner
+            {
+                uint64_t in_string_carry_ = 0; // all bits on if the previous block ended in a string
+                uint64_t token_carry_ = 0;     // 1 if the previous block ended in a token
+                bool escape_carry_ = false;
+
+            public:
+                struct structurals
+                {
+                    uint64_t operators{};      // `{}[]:,`
+                    uint64_t opening_quotes{};
+                    uint64_t token_starts{};   // the first characters of other tokens (literals, numbers)
+                };
+
+                // scans the next 64 bytes at `p`, or `[p, end)` padded with spaces if shorter.
+                [[nodiscard]] structurals scan(const char* p, const char* end) noexcept
+                {
+                    char tail[64];
+                    if (end - p < 64) // pads the last block with spaces
+                    {
+                        std::fill(std::copy(p, end, tail), tail + 64, ' ');
+                        p = tail;
+                    }
+
+                    const block_masks m = classify_block(p);
+                    const uint64_t quotes = m.quotes & ~escaped_mask(m.backslashes, escape_carry_);
+                    const uint64_t in_string = prefix_xor(quotes) ^ in_string_carry_; // opening quotes and string bodies
+                    in_string_carry_ = static_cast<uint64_t>(-static_cast<int64_t>(in_string >> 63));
+
+                    const uint64_t tokens = ~(m.whitespaces | m.operators | quotes | in_string);
+                    const uint64_t token_starts = tokens & ~(tokens << 1 | token_carry_);
+                    token_carry_ = tokens >> 63;
+
+                    return structurals{m.operators & ~in_string, quotes & in_string, token_starts};
+                }
+            };
+
+            // builds structural index of json text `[begin, end)`, the offsets from `base` of
+            // operators `{}[]:,` and opening quotes out of strings, and the first characters of other tokens (literals, numbers).
+            // `end - base` must fit in uint32_t.
+            inline void build_structural_index(const char* base, const char* begin, const char* end, std::vector<uint32_t>& index)
+            {
+                index.resize(static_cast<size_t>(end - begin) / 4 + 64);
+                size_t count = 0;
+
+                structural_scanner scanner{};
+                for (const char* p = begin; p < end; p += 64)
+                {
+                    const auto s = scanner.scan(p, end);
+                    uint64_t structurals = s.operators | s.opening_quotes | s.token_starts;
+                    if (index.size() - count < 64) index.resize(index.size() * 2);
+                    const auto offset = static_cast<uint32_t>(p - base);
+                    for (uint32_t* out = index.data() + count; structurals; structurals &= structurals - 1)
+                        *out++ = offset + static_cast<uint32_t>(count_trailing_zeros(structurals)), ++count;
+                }
+
+                index.resize(count);
+            }
+
+            // splits the elements of the array starting at `begin` (pointing `[`) by finding `,` and the closing `]` at depth 1,
+            // appends the positions of `,` and the closing `]` to `delimiters`. returns false if the array is not closed.
+            inline bool split_array_elements(const char* begin, const char* end, std::vector<const char*>& delimiters)
+            {
+                size_t depth = 0;
+                structural_scanner scanner{};
+                for (const char* p = begin; p < end; p += 64)
+                {
+                    for (uint64_t operators = scanner.scan(p, end).operators; operators; operators &= operators - 1)
+                    {
+                        const char* q = p + count_trailing_zeros(operators);
+                        switch (*q)
+                        {
+                        case '[':
+                        case '{':
+                            ++depth;
+                            break;
+                        case ']':
+                        case '}':
+                            if (--depth == 0) return delimiters.push_back(q), true;
+                            break;
+                        case ',':
+                            if (depth == 1) delimiters.push_back(q);
+                            break;
+                        default:
+                            break;
+                        }
+                    }
+                }
+                return false;
+            }
+
+            // finds the bracket closing the array or object containing `begin` (out of strings), returns nullptr if not closed.
+            inline const char* find_closing_bracket(const char* begin, const char* end)
+            {
+                size_t depth = 1;
+                structural_scanner scanner{};
+                for (const char* p = begin; p < end; p += 64)
+                {
+                    for (uint64_t operators = scanner.scan(p, end).operators; operators; operators &= operators - 1)
+                    {
+                        const char* q = p + count_trailing_zeros(operators);
+                        if (*q == '[' || *q == '{') ++depth;
+                        else if ((*q == ']' || *q == '}') && --depth == 0) return q;
+                    }
+                }
+                return nullptr;
+            }
+        }
+
+        // chunked storage for strings. stored strings never move until the storage is destroyed.
+        template <class CharType>
+        class string_arena
+        {
+            static constexpr size_t block_size = 4096;
+
+            std::vector<std::unique_ptr<CharType[]>> blocks_{};
+            CharType* cursor_{};
+            size_t remaining_{};
+
+        public:
+            // copies `s` into the storage, returns the view to stored string
+            [[nodiscard]] std::basic_string_view<CharType> store(std::basic_string_view<CharType> s)
+            {
+                if (s.empty()) return {};
+
+                CharType* p{};
+                if (s.size() <= remaining_) // fits in current block
+                {
+                    p = cursor_;
+                    cursor_ += s.size();
+                    remaining_ -= s.size();
+                }
+                else if (s.size() > block_size / 4) // large string gets its own block, keeping current block
+                {
+                    p = blocks_.emplace_back(std::make_unique<CharType[]>(s.size())).get();
+                }
+                else // opens new block
+                {
+                    p = blocks_.emplace_back(std::make_unique<CharType[]>(block_size)).get();
+                    cursor_ = p + s.size();
+                    remaining_ = block_size - s.size();
+                }
+
+                std::copy(s.begin(), s.end(), p);
+                return std::basic_string_view<CharType>(p, s.size());
+            }
+        };
+
+        // interning table of strings stored in string_arena: equal strings share one stored copy.
+        template <class CharType>
+        class string_interner
+        {
+            using string_view = std::basic_string_view<CharType>;
+
+            string_arena<CharType>* arena_{};
+            std::vector<string_view> table_{}; // open addressing hash table (free slots have null data)
+            size_t count_{};
+
+        public:
+            string_interner() = default;
+            explicit string_interner(string_arena<CharType>* arena) : arena_(arena) { }
+
+            // gets true if the interner has storage
+            [[nodiscard]] bool enabled() const noexcept { return arena_ != nullptr; }
+
+            // gets the stored copy of `s`, storing it if not yet
+            [[nodiscard]] string_view intern(string_view s)
+            {
+                if (s.empty()) return {};
+                if ((count_ + 1) * 2 > table_.size()) rehash((std::max)(table_.size() * 2, size_t{64}));
+
+                const size_t mask = table_.size() - 1;
+                for (size_t h = std::hash<string_view>{}(s) & mask;; h = (h + 1) & mask)
+                {
+                    if (table_[h].data() == nullptr) return ++count_, table_[h] = arena_->store(s);
+                    if (table_[h].compare(s) == 0) return table_[h];
+                }
+            }
+
+        private:
+            void rehash(size_t size)
+            {
+                std::vector<string_view> old(size);
+                old.swap(table_);
+                const size_t mask = size - 1;
+                for (const string_view& s : old)
+                {
+                    if (s.data() == nullptr) continue;
+                    size_t h = std::hash<string_view>{}(s) & mask;
+                    while (table_[h].data() != nullptr) h = (h + 1) & mask;
+                    table_[h] = s;
+                }
+            }
+        };
+
+        // number kept as its text in the source (see `json_parse_option::raw_number`), converted when it is read as integer or floating.
+        template <class String>
+        class raw_number
+        {
+            String text_{};
+
+        public:
+            raw_number() = default;
+            explicit raw_number(String text) : text_(std::move(text)) { }
+
+            // gets the text
+            [[nodiscard]] const String& text() const noexcept { return text_; }
+
+            [[nodiscard]] friend bool operator ==(const raw_number& lhs, const raw_number& rhs) noexcept { return lhs.text_.compare(rhs.text_) == 0; }
+            [[nodiscard]] friend bool operator !=(const raw_number& lhs, const raw_number& rhs) noexcept { return lhs.text_.compare(rhs.text_) != 0; }
+        };
+
+        // gets the number of worker threads: `requested`, or the number of hardware threads if `requested` is 0.
+        [[nodiscard]] inline size_t worker_thread_count(size_t requested) noexcept
+        {
+            return requested != 0 ? requested : (std::max)(size_t{1}, static_cast<size_t>(std::thread::hardware_concurrency()));
+        }
+
+        // runs `task(cancelled)` on `thread_count` threads (including the calling thread).
+        // if a task throws, sets `cancelled` to stop the others, then rethrows the first exception after all tasks finished.
+        template <class Task>
+        void run_parallel(size_t thread_count, Task&& task)
+        {
+            std::atomic<bool> cancelled{false};
+            std::exception_ptr error{};
+            std::mutex error_mutex{};
+
+            auto run = [&]() noexcept
+            {
+                try
+                {
+                    task(static_cast<const std::atomic<bool>&>(cancelled));
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error) error = std::current_exception();
+                    cancelled = true;
+                }
+            };
+
+            std::vector<std::thread> threads;
+            threads.reserve(thread_count);
+            try
+            {
+                for (size_t i = 1; i < thread_count; i++)
+                    threads.emplace_back(run);
+            }
+            catch (const std::system_error&)
+            {
+                // continues with fewer threads
+            }
+
+            run();
+            for (auto& t : threads) t.join();
+            if (error) std::rethrow_exception(error);
+        }
+
+        // reads a streambuf in blocks with `sgetn`, taking only the characters already buffered in it (so that reading never waits for more input than needed).
+        // `release` returns the characters not consumed through `iterator` back to the streambuf.
+        template <class CharType, class Traits>
+        class streambuf_reader
+        {
+            std::basic_streambuf<CharType, Traits>* streambuf_;
+            CharType* it_{};
+            CharType* end_{};
+            CharType window_[4096];
+
+            // reads next block into the window, returns false at the end of the stream
+            bool refill()
+            {
+                if (!streambuf_ || Traits::eq_int_type(streambuf_->sgetc(), Traits::eof())) return false;
+                const std::streamsize available = (std::clamp)(streambuf_->in_avail(), std::streamsize{1}, static_cast<std::streamsize>(std::size(window_)));
+                it_ = window_;
+                end_ = window_ + (std::max)(streambuf_->sgetn(window_, available), std::streamsize{0});
+                return it_ != end_;
+            }
+
+        public:
+            explicit streambuf_reader(std::basic_streambuf<CharType, Traits>* streambuf) : streambuf_(streambuf) { }
+            streambuf_reader(const streambuf_reader& other) = delete;
+            streambuf_reader& operator=(const streambuf_reader& other) = delete;
+            ~streambuf_reader() { (void)release(); }
+
+            // returns the characters not consumed back to the streambuf. returns false if the streambuf can't take them back.
+            bool release()
+            {
+                bool ok = true;
+                while (end_ != it_ && ok) ok = !Traits::eq_int_type(streambuf_->sputbackc(*--end_), Traits::eof());
+                it_ = end_ = window_;
+                return ok;
+            }
+
+            // single-pass input iterator over the stream (default constructed one is the end)
+            class iterator
+            {
+                streambuf_reader* reader_{};
+
+                [[nodiscard]] bool at_end() const { return !reader_ || (reader_->it_ == reader_->end_ && !reader_->refill()); }
+
+            public:
+                using iterator_category = std::input_iterator_tag;
+                using value_type = CharType;
+                using difference_type = std::streamoff;
+                using pointer = const CharType*;
+                using reference = const CharType&;
+
+                iterator() = default;
+                explicit iterator(streambuf_reader* reader) : reader_(reader) { }
+
+                [[nodiscard]] reference operator *() const { return (void)at_end(), *reader_->it_; } // (not at the end)
+                iterator& operator ++() { return (void)(at_end() || ++reader_->it_), *this; }
+                [[nodiscard]] friend bool operator ==(const iterator& lhs, const iterator& rhs) { return lhs.at_end() == rhs.at_end(); }
+                [[nodiscard]] friend bool operator !=(const iterator& lhs, const iterator& rhs) { return lhs.at_end() != rhs.at_end(); }
+            };
+
+            [[nodiscard]] iterator begin() { return iterator(this); }
+            [[nodiscard]] iterator end() { return iterator(); }
+        };
+
+        // writes to a streambuf in blocks with `sputn`.
+        template <class CharType, class Traits>
+        class streambuf_writer
+        {
+            std::basic_streambuf<CharType, Traits>* streambuf_;
+            size_t size_{};
+            bool failed_{};
+            CharType buffer_[4096];
+
+        public:
+            explicit streambuf_writer(std::basic_streambuf<CharType, Traits>* streambuf) : streambuf_(streambuf), failed_(streambuf == nullptr) { }
+            streambuf_writer(const streambuf_writer& other) = delete;
+            streambuf_writer& operator=(const streambuf_writer& other) = delete;
+            ~streambuf_writer() { (void)flush(); }
+
+            void put(CharType c)
+            {
+                if (size_ == std::size(buffer_)) (void)flush();
+                buffer_[size_++] = c;
+            }
+
+            // writes buffered characters to the streambuf. returns false if the streambuf failed to write (now or before).
+            bool flush()
+            {
+                if (!failed_ && size_ != 0) failed_ = streambuf_->sputn(buffer_, static_cast<std::streamsize>(size_)) != static_cast<std::streamsize>(size_);
+                size_ = 0;
+                return !failed_;
+            }
+
+            // output iterator to the stream
+            class iterator
+            {
+                streambuf_writer* writer_;
+
+            public:
+                using iterator_category = std::output_iterator_tag;
+                using value_type = void;
+                using difference_type = std::ptrdiff_t;
+                using pointer = void;
+                using reference = void;
+
+                explicit iterator(streambuf_writer* writer) : writer_(writer) { }
+                iterator& operator =(CharType c) { return writer_->put(c), *this; }
+                iterator& operator *() { return *this; }
+                iterator& operator ++() { return *this; }
+                iterator& operator ++(int) { return *this; }
+            };
+
+            [[nodiscard]] iterator begin() { return iterator(this); }
+        };
     }
 
     inline namespace exceptions
@@ -300,6 +993,7 @@ namespace nanojson3
         string,
         array,
         object,
+        raw_number,
     };
 
     template <json_type_index i>
@@ -318,6 +1012,7 @@ namespace nanojson3
         static constexpr inline in_place_index_t<json_type_index::string> string{};
         static constexpr inline in_place_index_t<json_type_index::array> array{};
         static constexpr inline in_place_index_t<json_type_index::object> object{};
+        static constexpr inline in_place_index_t<json_type_index::raw_number> raw_number{};
     };
 
     enum struct json_parse_option : unsigned long
@@ -329,7 +1024,17 @@ namespace nanojson3
         allow_trailing_comma = 1ul << 3,
         allow_unquoted_object_key = 1ul << 4,
         allow_number_with_plus_sign = 1ul << 5,
-        all = ~0u,
+        all = allow_utf8_bom | allow_unescaped_forward_slash | allow_comment | allow_trailing_comma | allow_unquoted_object_key | allow_number_with_plus_sign,
+
+        // duplicate object keys: by default, the last value wins (at the position of the first key).
+        keep_first_duplicate_key = 1ul << 6, // the first value wins
+        reject_duplicate_key = 1ul << 7,     // throws bad_format
+
+        // keeps numbers as their text (`js_raw_number`), converted when they are read by `get_integer()` etc., and written as is.
+        raw_number = 1ul << 8,
+
+        // rejects strings and object keys which are not valid UTF-8 (including overlong forms, surrogates and code points beyond U+10FFFF).
+        validate_utf8 = 1ul << 9,
 
         // default_option
         default_option = allow_utf8_bom | allow_unescaped_forward_slash,
@@ -362,7 +1067,7 @@ namespace nanojson3
     struct json_floating_format_options
     {
         std::chars_format floating_format = std::chars_format::general; // general, fixed, scientific
-        int floating_precision = 7;
+        int floating_precision = 7; // negative: the shortest text reading back the same value (`floating_format` is ignored)
     };
 
     // json_serializer : placeholder
@@ -379,6 +1084,16 @@ namespace nanojson3
         }
     };
 
+    // json_deserializer : placeholder
+    template <class T, class U = void>
+    struct json_deserializer
+    {
+        // To make your type readable by `parse_into`, give it `json_fields` (see `json_field`),
+        // or specialize this class and implement the following method for your type `T`.
+        // `cursor` is at the first token of the value (see `json_cursor`). read the value to its last token.
+        //   template <class Cursor> static void deserialize(Cursor& cursor, T& value) { /* implement here */ }
+    };
+
     /// json: represents a json element
     class json final
     {
@@ -393,18 +1108,19 @@ namespace nanojson3
         using js_null = std::nullptr_t;
         using js_boolean = bool;
         using js_integer = long long int;
-        using js_floating = long double;
+        using js_floating = NANOJSON3_FLOATING_TYPE;
         using js_number = js_floating; // integer or floating
         using js_string = std::basic_string<char_type, char_traits, allocator_type_for<char_type>>;
         using js_string_view = std::basic_string_view<char_type, char_traits>;
         using js_array_index = size_t;
         using js_array_index_view = size_t;
         using js_array = std::vector<json, allocator_type_for<json>>;
-        using js_object_key = js_string;
+        using js_object_key = js_string; // owns its copy, so keys of `json` are not interned (see `parse_json_document` and `parse_json_tape` for interned keys)
         using js_object_key_view = js_string_view;
         using js_object_kvp = internal::key_value_pair<js_object_key, json>;
         using js_object = internal::key_value_store<js_object_key, json, std::equal_to<>, std::vector<js_object_kvp, allocator_type_for<js_object_kvp>>>;
-        using js_variant = std::variant<js_undefined, js_null, js_boolean, js_integer, js_floating, js_string, js_array, js_object>;
+        using js_raw_number = internal::raw_number<js_string>;
+        using js_variant = std::variant<js_undefined, js_null, js_boolean, js_integer, js_floating, js_string, js_array, js_object, js_raw_number>;
         template <json_type_index ti> using js_type_by_index = std::variant_alternative_t<static_cast<size_t>(ti), js_variant>;
 
         using json_string = std::basic_string<char_type, char_traits, allocator_type_for<char_type>>;
@@ -412,6 +1128,7 @@ namespace nanojson3
 
     private: // holds a json element value
         js_variant value_{};
+        template <class Node> friend class json_document_builder;
 
     public: // constructors
         json() = default;
@@ -431,6 +1148,7 @@ namespace nanojson3
         json(const js_string& value) : json(in_place_index::string, std::forward<decltype(value)>(value)) { }
         json(const js_array& value) : json(in_place_index::array, std::forward<decltype(value)>(value)) { }
         json(const js_object& value) : json(in_place_index::object, std::forward<decltype(value)>(value)) { }
+        json(const js_raw_number& value) : json(in_place_index::raw_number, std::forward<decltype(value)>(value)) { }
 
         json(js_undefined&& value) : json(in_place_index::undefined, std::forward<decltype(value)>(value)) { }
         json(js_null&& value) : json(in_place_index::null, std::forward<decltype(value)>(value)) { }
@@ -440,6 +1158,7 @@ namespace nanojson3
         json(js_string&& value) : json(in_place_index::string, std::forward<decltype(value)>(value)) { }
         json(js_array&& value) : json(in_place_index::array, std::forward<decltype(value)>(value)) { }
         json(js_object&& value) : json(in_place_index::object, std::forward<decltype(value)>(value)) { }
+        json(js_raw_number&& value) : json(in_place_index::raw_number, std::forward<decltype(value)>(value)) { }
 
         // serialize construct
         template <class T, std::enable_if_t<std::is_same_v<decltype(json_serializer<std::decay_t<T>>::serialize(std::declval<T>())), json>>* = nullptr>
@@ -463,20 +1182,39 @@ namespace nanojson3
         template <class CharInputIterator> struct json_reader;
         template <class CharOutputIterator> struct json_writer;
         [[nodiscard]] static json parse(const json_string_view& source, json_parse_option opt = json_parse_option::default_option);
+        [[nodiscard]] static json parse_number(const json_string_view& text) noexcept; // integer or floating (undefined if malformed)
         [[nodiscard]] json_string serialize(json_serialize_option opt = json_serialize_option::none, json_floating_format_options format = json_floating_format_options{}) const;
 
     public: // value access operators
-        template <class js_variant_ref, std::enable_if_t<std::is_same_v<js_variant_ref, js_variant&> || std::is_same_v<js_variant_ref, const js_variant&>> * = nullptr>
+        // js_variant_ref: reference to js_variant (or json_view::js_variant)
+        template <class js_variant_ref, std::enable_if_t<std::is_reference_v<js_variant_ref>> * = nullptr>
         class json_value_reference_container
         {
+            using variant_type = std::remove_cv_t<std::remove_reference_t<js_variant_ref>>;
+            template <json_type_index ti> using js_type_by_index = std::variant_alternative_t<static_cast<size_t>(ti), variant_type>;
+            using js_string = js_type_by_index<json_type_index::string>;
+            using js_array = js_type_by_index<json_type_index::array>;
+            using js_object = js_type_by_index<json_type_index::object>;
+            using js_raw_number = js_type_by_index<json_type_index::raw_number>;
+
             js_variant_ref& value_;
 
+            // converts raw number into `T` (js_integer or js_floating) as json_reader does, returns nullopt if it is not raw number or becomes other type.
+            template <class T>
+            [[nodiscard]] std::optional<T> raw_number_as() const noexcept
+            {
+                if (const auto raw = as_raw_number())
+                    if (const json value = json::parse_number(raw->text()); std::holds_alternative<T>(value.value_))
+                        return std::get<T>(value.value_);
+                return std::nullopt;
+            }
+
         public:
             json_value_reference_container(js_variant_ref& ref) : value_(ref) {}
             const json_value_reference_container* operator ->() const noexcept { return this; }
 
             [[nodiscard]] json_type_index get_type() const noexcept { return static_cast<json_type_index>(value_.index()); }
-            [[nodiscard]] const js_variant& as_variant() const noexcept { return value_; }
+            [[nodiscard]] const variant_type& as_variant() const noexcept { return value_; }
 
             template <json_type_index TypeIndex> [[nodiscard]] bool is() const noexcept { return get_type() == TypeIndex; }
             [[nodiscard]] bool is_undefined() const noexcept { return is<json_type_index::undefined>(); }
@@ -487,6 +1225,7 @@ namespace nanojson3
             [[nodiscard]] bool is_string() const noexcept { return is<json_type_index::string>(); }
             [[nodiscard]] bool is_array() const noexcept { return is<json_type_index::array>(); }
             [[nodiscard]] bool is_object() const noexcept { return is<json_type_index::object>(); }
+            [[nodiscard]] bool is_raw_number() const noexcept { return is<json_type_index::raw_number>(); }
 
             // returns nullptr if type is mismatch
             template <json_type_index TypeIndex> [[nodiscard]] auto as() const noexcept { return std::get_if<js_type_by_index<TypeIndex>>(&value_); }
@@ -497,40 +1236,48 @@ namespace nanojson3
             [[nodiscard]] auto* as_string() const noexcept { return as<json_type_index::string>(); }
             [[nodiscard]] auto* as_array() const noexcept { return as<json_type_index::array>(); }
             [[nodiscard]] auto* as_object() const noexcept { return as<json_type_index::object>(); }
+            [[nodiscard]] auto* as_raw_number() const noexcept { return as<json_type_index::raw_number>(); }
 
             // throws bad_access if type is mismatch
             template <json_type_index TypeIndex> [[nodiscard]] auto get() const { return is<TypeIndex>() ? *as<TypeIndex>() : throw bad_access(); }
             [[nodiscard]] js_null get_null() const { return get<json_type_index::null>(); }
             [[nodiscard]] js_boolean get_boolean() const { return get<json_type_index::boolean>(); }
-            [[nodiscard]] js_integer get_integer() const { return get<json_type_index::integer>(); }
-            [[nodiscard]] js_floating get_floating() const { return get<json_type_index::floating>(); }
+            [[nodiscard]] js_integer get_integer() const { if (const auto num = raw_number_as<js_integer>()) return *num; return get<json_type_index::integer>(); }
+            [[nodiscard]] js_floating get_floating() const { if (const auto num = raw_number_as<js_floating>()) return *num; return get<json_type_index::floating>(); }
             [[nodiscard]] js_string get_string() const { return get<json_type_index::string>(); }
             [[nodiscard]] js_array get_array() const { return get<json_type_index::array>(); }
             [[nodiscard]] js_object get_object() const { return get<json_type_index::object>(); }
+            [[nodiscard]] js_raw_number get_raw_number() const { return get<json_type_index::raw_number>(); }
 
             // returns default_value if type is mismatch
             template <json_type_index TypeIndex, class U = js_type_by_index<TypeIndex>, std::enable_if_t<std::is_convertible_v<U, js_type_by_index<TypeIndex>>>* = nullptr> [[nodiscard]] js_type_by_index<TypeIndex> get_or(U&& default_value) const noexcept { return as<TypeIndex>() ? *as<TypeIndex>() : static_cast<js_type_by_index<TypeIndex>>(std::forward<U>(default_value)); }
             template <class U = js_null, std::enable_if_t<std::is_convertible_v<U, js_null>>* = nullptr> [[nodiscard]] js_null get_null_or(U&& default_value) const noexcept { return get_or<json_type_index::null>(std::forward<U>(default_value)); }
             template <class U = js_boolean, std::enable_if_t<std::is_convertible_v<U, js_boolean>>* = nullptr> [[nodiscard]] js_boolean get_boolean_or(U&& default_value) const noexcept { return get_or<json_type_index::boolean>(std::forward<U>(default_value)); }
-            template <class U = js_integer, std::enable_if_t<std::is_convertible_v<U, js_integer>>* = nullptr> [[nodiscard]] js_integer get_integer_or(U&& default_value) const noexcept { return get_or<json_type_index::integer>(std::forward<U>(default_value)); }
-            template <class U = js_floating, std::enable_if_t<std::is_convertible_v<U, js_floating>>* = nullptr> [[nodiscard]] js_floating get_floating_or(U&& default_value) const noexcept { return get_or<json_type_index::floating>(std::forward<U>(default_value)); }
+            template <class U = js_integer, std::enable_if_t<std::is_convertible_v<U, js_integer>>* = nullptr> [[nodiscard]] js_integer get_integer_or(U&& default_value) const noexcept { if (const auto num = raw_number_as<js_integer>()) return *num; return get_or<json_type_index::integer>(std::forward<U>(default_value)); }
+            template <class U = js_floating, std::enable_if_t<std::is_convertible_v<U, js_floating>>* = nullptr> [[nodiscard]] js_floating get_floating_or(U&& default_value) const noexcept { if (const auto num = raw_number_as<js_floating>()) return *num; return get_or<json_type_index::floating>(std::forward<U>(default_value)); }
             template <class U = js_string, std::enable_if_t<std::is_convertible_v<U, js_string>>* = nullptr> [[nodiscard]] js_string get_string_or(U&& default_value) const noexcept { return get_or<json_type_index::string>(std::forward<U>(default_value)); }
             template <class U = js_array, std::enable_if_t<std::is_convertible_v<U, js_array>>* = nullptr> [[nodiscard]] js_array get_array_or(U&& default_value) const noexcept { return get_or<json_type_index::array>(std::forward<U>(default_value)); }
             template <class U = js_object, std::enable_if_t<std::is_convertible_v<U, js_object>>* = nullptr> [[nodiscard]] js_object get_object_or(U&& default_value) const noexcept { return get_or<json_type_index::object>(std::forward<U>(default_value)); }
 
             [[nodiscard]] bool is_defined() const noexcept { return !is_undefined(); }
 
-            // (integer or floating) as floating
+            // (integer, floating or raw number) as floating
             [[nodiscard]] bool is_number() const noexcept
             {
-                return is_integer() || is_number();
+                return is_integer() || is_floating() || is_raw_number();
             }
 
-            // (integer or floating) as floating
+            // (integer, floating or raw number) as floating
             [[nodiscard]] std::optional<js_number> as_number() const noexcept
             {
                 if (const auto num = as_integer()) return std::make_optional(static_cast<js_number>(*num));
                 if (const auto num = as_floating()) return std::make_optional(static_cast<js_number>(*num));
+                if (const auto raw = as_raw_number())
+                {
+                    const json value = json::parse_number(raw->text());
+                    if (const auto num = value.as_integer()) return std::make_optional(static_cast<js_number>(*num));
+                    if (const auto num = value.as_floating()) return std::make_optional(static_cast<js_number>(*num));
+                }
                 return std::nullopt;
             }
 
@@ -593,6 +1340,7 @@ namespace nanojson3
         [[nodiscard]] bool is_string() const noexcept { return value().is_string(); }
         [[nodiscard]] bool is_array() const noexcept { return value().is_array(); }
         [[nodiscard]] bool is_object() const noexcept { return value().is_object(); }
+        [[nodiscard]] bool is_raw_number() const noexcept { return value().is_raw_number(); }
 
         // returns nullptr if type is mismatch
         template <json_type_index TypeIndex> [[nodiscard]] const auto* as() const noexcept { return value().as<TypeIndex>(); }
@@ -604,6 +1352,7 @@ namespace nanojson3
         [[nodiscard]] const js_string* as_string() const noexcept { return value().as_string(); }
         [[nodiscard]] const js_array* as_array() const noexcept { return value().as_array(); }
         [[nodiscard]] const js_object* as_object() const noexcept { return value().as_object(); }
+        [[nodiscard]] const js_raw_number* as_raw_number() const noexcept { return value().as_raw_number(); }
 
         template <json_type_index TypeIndex> [[nodiscard]] auto* as() noexcept { return value().as<TypeIndex>(); }
         [[nodiscard]] js_null* as_null() noexcept { return value().as_null(); }
@@ -613,6 +1362,7 @@ namespace nanojson3
         [[nodiscard]] js_string* as_string() noexcept { return value().as_string(); }
         [[nodiscard]] js_array* as_array() noexcept { return value().as_array(); }
         [[nodiscard]] js_object* as_object() noexcept { return value().as_object(); }
+        [[nodiscard]] js_raw_number* as_raw_number() noexcept { return value().as_raw_number(); }
 
         // throws bad_access if type is mismatch
         template <json_type_index TypeIndex> [[nodiscard]] auto get() const { return value().get<TypeIndex>(); }
@@ -624,6 +1374,7 @@ namespace nanojson3
         [[nodiscard]] js_string get_string() const { return value().get_string(); }
         [[nodiscard]] js_array get_array() const { return value().get_array(); }
         [[nodiscard]] js_object get_object() const { return value().get_object(); }
+        [[nodiscard]] js_raw_number get_raw_number() const { return value().get_raw_number(); }
 
         // returns default_value if type is mismatch
         template <json_type_index TypeIndex, class U = js_type_by_index<TypeIndex>, std::enable_if_t<std::is_convertible_v<U, js_type_by_index<TypeIndex>>>* = nullptr> [[nodiscard]] js_type_by_index<TypeIndex> get_or(U&& default_value) const { return value().get_or<TypeIndex>(std::forward<U>(default_value)); }
@@ -691,6 +1442,7 @@ namespace nanojson3
         [[nodiscard]] bool is_string() const noexcept { return value().is_string(); }
         [[nodiscard]] bool is_array() const noexcept { return value().is_array(); }
         [[nodiscard]] bool is_object() const noexcept { return value().is_object(); }
+        [[nodiscard]] bool is_raw_number() const noexcept { return value().is_raw_number(); }
 
         // returns nullptr if type is mismatch
         template <json_type_index TypeIndex> [[nodiscard]] auto* as() const noexcept { return value().as<TypeIndex>(); }
@@ -702,6 +1454,7 @@ namespace nanojson3
         [[nodiscard]] js_string* as_string() const noexcept { return value().as_string(); }
         [[nodiscard]] js_array* as_array() const noexcept { return value().as_array(); }
         [[nodiscard]] js_object* as_object() const noexcept { return value().as_object(); }
+        [[nodiscard]] js_raw_number* as_raw_number() const noexcept { return value().as_raw_number(); }
 
         // throws bad_access if type is mismatch
         template <json_type_index TypeIndex> [[nodiscard]] auto get() const { return value().get<TypeIndex>(); }
@@ -713,6 +1466,7 @@ namespace nanojson3
         [[nodiscard]] js_string get_string() const { return value().get_string(); }
         [[nodiscard]] js_array get_array() const { return value().get_array(); }
         [[nodiscard]] js_object get_object() const { return value().get_object(); }
+        [[nodiscard]] js_raw_number get_raw_number() const { return value().get_raw_number(); }
 
         // returns default_value if type is mismatch
         template <json_type_index TypeIndex, class U = js_type_by_index<TypeIndex>, std::enable_if_t<std::is_convertible_v<U, js_type_by_index<TypeIndex>>>* = nullptr> [[nodiscard]] js_type_by_index<TypeIndex> get_or(U&& default_value) const { return value().get_or<TypeIndex>(std::forward<U>(default_value)); }
@@ -823,582 +1577,3359 @@ namespace nanojson3
     [[nodiscard]] inline bool operator ==(const json::json_reference& lhs, const json::json_reference& rhs) noexcept { return lhs->as_variant() == rhs->as_variant(); }
     [[nodiscard]] inline bool operator !=(const json::json_reference& lhs, const json::json_reference& rhs) noexcept { return lhs->as_variant() != rhs->as_variant(); }
 
-    // input/output
-
-    template <class CharInputIterator>
-    struct json::json_reader
+    /// json_view_accessors: value access shortcuts of read-only json elements (json_view, json_lazy_view), forwarded to `Derived::value()`.
+    /// Type queries (`get_type()`, `is_*()`) are forwarded to `Derived::peek()`, which gets the value without reading anything.
+    template <class Derived>
+    class json_view_accessors
     {
-    public:
-        static json read_json(CharInputIterator begin, CharInputIterator end, json_parse_option loose_option)
-        {
-            return json_reader(begin, end, loose_option).execute();
+        [[nodiscard]] const Derived& derived() const noexcept { return static_cast<const Derived&>(*this); }
+        [[nodiscard]] static constexpr bool nothrow() noexcept { return noexcept(std::declval<const Derived&>().value()); }
+
+    public: // value access shortcuts
+
+        [[nodiscard]] json_type_index get_type() const noexcept { return derived().peek().get_type(); }
+        [[nodiscard]] decltype(auto) as_variant() const noexcept(nothrow()) { return derived().value().as_variant(); }
+
+        template <json_type_index TypeIndex> [[nodiscard]] bool is() const noexcept { return derived().peek().template is<TypeIndex>(); }
+        [[nodiscard]] bool is_defined() const noexcept { return derived().peek().is_defined(); }
+        [[nodiscard]] bool is_undefined() const noexcept { return derived().peek().is_undefined(); }
+        [[nodiscard]] bool is_null() const noexcept { return derived().peek().is_null(); }
+        [[nodiscard]] bool is_boolean() const noexcept { return derived().peek().is_boolean(); }
+        [[nodiscard]] bool is_integer() const noexcept { return derived().peek().is_integer(); }
+        [[nodiscard]] bool is_floating() const noexcept { return derived().peek().is_floating(); }
+        [[nodiscard]] bool is_number() const noexcept { return derived().peek().is_number(); }
+        [[nodiscard]] bool is_string() const noexcept { return derived().peek().is_string(); }
+        [[nodiscard]] bool is_array() const noexcept { return derived().peek().is_array(); }
+        [[nodiscard]] bool is_object() const noexcept { return derived().peek().is_object(); }
+        [[nodiscard]] bool is_raw_number() const noexcept { return derived().peek().is_raw_number(); }
+
+        // returns nullptr if type is mismatch
+        template <json_type_index TypeIndex> [[nodiscard]] const auto* as() const noexcept(nothrow()) { return derived().value().template as<TypeIndex>(); }
+        [[nodiscard]] auto as_null() const noexcept(nothrow()) { return derived().value().as_null(); }
+        [[nodiscard]] auto as_boolean() const noexcept(nothrow()) { return derived().value().as_boolean(); }
+        [[nodiscard]] auto as_integer() const noexcept(nothrow()) { return derived().value().as_integer(); }
+        [[nodiscard]] auto as_floating() const noexcept(nothrow()) { return derived().value().as_floating(); }
+        [[nodiscard]] auto as_number() const noexcept(nothrow()) { return derived().value().as_number(); }
+        [[nodiscard]] auto as_string() const noexcept(nothrow()) { return derived().value().as_string(); }
+        [[nodiscard]] auto as_array() const noexcept(nothrow()) { return derived().value().as_array(); }
+        [[nodiscard]] auto as_object() const noexcept(nothrow()) { return derived().value().as_object(); }
+        [[nodiscard]] auto as_raw_number() const noexcept(nothrow()) { return derived().value().as_raw_number(); }
+
+        // throws bad_access if type is mismatch
+        template <json_type_index TypeIndex> [[nodiscard]] auto get() const { return derived().value().template get<TypeIndex>(); }
+        [[nodiscard]] auto get_null() const { return derived().value().get_null(); }
+        [[nodiscard]] auto get_boolean() const { return derived().value().get_boolean(); }
+        [[nodiscard]] auto get_integer() const { return derived().value().get_integer(); }
+        [[nodiscard]] auto get_floating() const { return derived().value().get_floating(); }
+        [[nodiscard]] auto get_number() const { return derived().value().get_number(); }
+        [[nodiscard]] auto get_string() const { return derived().value().get_string(); }
+        [[nodiscard]] auto get_array() const { return derived().value().get_array(); }
+        [[nodiscard]] auto get_object() const { return derived().value().get_object(); }
+        [[nodiscard]] auto get_raw_number() const { return derived().value().get_raw_number(); }
+
+        // returns default_value if type is mismatch
+        template <json_type_index TypeIndex, class D = Derived, class U = typename D::template js_type_by_index<TypeIndex>> [[nodiscard]] auto get_or(U&& default_value) const { return derived().value().template get_or<TypeIndex>(std::forward<U>(default_value)); }
+        template <class D = Derived, class U = typename D::js_null> [[nodiscard]] auto get_null_or(U&& default_value) const { return derived().value().get_null_or(std::forward<U>(default_value)); }
+        template <class D = Derived, class U = typename D::js_boolean> [[nodiscard]] auto get_boolean_or(U&& default_value) const { return derived().value().get_boolean_or(std::forward<U>(default_value)); }
+        template <class D = Derived, class U = typename D::js_integer> [[nodiscard]] auto get_integer_or(U&& default_value) const { return derived().value().get_integer_or(std::forward<U>(default_value)); }
+        template <class D = Derived, class U = typename D::js_floating> [[nodiscard]] auto get_floating_or(U&& default_value) const { return derived().value().get_floating_or(std::forward<U>(default_value)); }
+        template <class D = Derived, class U = typename D::js_number> [[nodiscard]] auto get_number_or(U&& default_value) const { return derived().value().get_number_or(std::forward<U>(default_value)); }
+        template <class D = Derived, class U = typename D::js_string> [[nodiscard]] auto get_string_or(U&& default_value) const { return derived().value().get_string_or(std::forward<U>(default_value)); }
+        template <class D = Derived, class U = typename D::js_array> [[nodiscard]] auto get_array_or(U&& default_value) const { return derived().value().get_array_or(std::forward<U>(default_value)); }
+        template <class D = Derived, class U = typename D::js_object> [[nodiscard]] auto get_object_or(U&& default_value) const { return derived().value().get_object_or(std::forward<U>(default_value)); }
+    };
+
+    /// json_view: represents a read-only json element whose strings and object keys refer to external storage (such as the source text).
+    /// The storage must outlive the view.
+    class json_view final : public json_view_accessors<json_view>
+    {
+    public: // typedefs
+        using char_type = json::char_type;
+        using char_traits = json::char_traits;
+
+        using js_undefined = json::js_undefined;
+        using js_null = json::js_null;
+        using js_boolean = json::js_boolean;
+        using js_integer = json::js_integer;
+        using js_floating = json::js_floating;
+        using js_number = json::js_number;
+        using js_string = json::js_string_view;
+        using js_string_view = json::js_string_view;
+        using js_array_index = json::js_array_index;
+        using js_array_index_view = json::js_array_index_view;
+        using js_array = std::vector<json_view>;
+        using js_object_key = json::js_object_key_view;
+        using js_object_key_view = json::js_object_key_view;
+        using js_object_kvp = internal::key_value_pair<js_object_key, json_view>;
+        using js_object = internal::key_value_store<js_object_key, json_view, std::equal_to<>, std::vector<js_object_kvp>>;
+        using js_raw_number = internal::raw_number<js_string_view>;
+        using js_variant = std::variant<js_undefined, js_null, js_boolean, js_integer, js_floating, js_string, js_array, js_object, js_raw_number>;
+        template <json_type_index ti> using js_type_by_index = std::variant_alternative_t<static_cast<size_t>(ti), js_variant>;
+
+    private: // holds a json element value
+        js_variant value_{};
+        template <class Node> friend class json_document_builder;
+        friend class json_view_accessors<json_view>;
+
+    public: // constructors
+        json_view() = default;
+        json_view(const json_view& other) = default;
+        json_view(json_view&& other) noexcept = default;
+        json_view& operator=(const json_view& other) = default;
+        json_view& operator=(json_view&& other) noexcept = default;
+        ~json_view() = default;
+
+        template <json_type_index type_index, class... Args>
+        json_view(in_place_index_t<type_index> index, Args&&... args) : value_(index, std::forward<Args>(args)...) { }
+
+    public: // conversion
+        // makes a `json` owning copies of all values (and makes `json(json_view)` constructor callable.)
+        [[nodiscard]] json to_json() const;
+
+    public: // undefined_reference
+        [[nodiscard]] static const json_view& undefined_reference() noexcept
+        {
+            static json_view undefined{};
+            return undefined;
+        }
+
+    public: // accessors
+        using const_json_view_value_ref = json::json_value_reference_container<const js_variant&>;
+
+        [[nodiscard]] const_json_view_value_ref value() const noexcept { return const_json_view_value_ref{value_}; }
+        [[nodiscard]] const_json_view_value_ref operator *() const noexcept { return value(); }
+        [[nodiscard]] const_json_view_value_ref operator ->() const noexcept { return value(); }
+        [[nodiscard]] const json_view& operator [](js_array_index_view index) const noexcept; // array[index]
+        [[nodiscard]] const json_view& operator [](js_object_key_view key) const noexcept;    // object[key]
+
+    private:
+        [[nodiscard]] const_json_view_value_ref peek() const noexcept { return value(); }
+    };
+
+    // const array[index]
+    inline const json_view& json_view::operator[](js_array_index_view index) const noexcept
+    {
+        if (const auto a = value().as_array())
+            if (index < a->size())
+                return a->operator[](index);
+
+        return undefined_reference();
+    }
+
+    // const object[key]
+    inline const json_view& json_view::operator[](js_object_key_view key) const noexcept
+    {
+        if (const auto o = value().as_object())
+            if (const auto it = o->find(key); it != o->end())
+                return it->second;
+
+        return undefined_reference();
+    }
+
+    [[nodiscard]] inline bool operator ==(const json_view& lhs, const json_view& rhs) noexcept { return lhs->as_variant() == rhs->as_variant(); }
+    [[nodiscard]] inline bool operator !=(const json_view& lhs, const json_view& rhs) noexcept { return lhs->as_variant() != rhs->as_variant(); }
+
+    /// json_view_document: owns a json_view tree and the storage of strings decoded from escape sequences.
+    /// Other strings refer to the source text, so the source text must outlive the document
+    /// (unless it is made by `parse_json_document`, which copies all strings into the storage).
+    class json_view_document final
+    {
+        std::unique_ptr<internal::string_arena<json::char_type>> storage_ = std::make_unique<internal::string_arena<json::char_type>>();
+        json_view root_{};
+
+    public:
+        json_view_document() = default;
+        json_view_document(const json_view_document& other) = delete;
+        json_view_document(json_view_document&& other) noexcept = default;
+        json_view_document& operator=(const json_view_document& other) = delete;
+        json_view_document& operator=(json_view_document&& other) noexcept = default;
+        ~json_view_document() = default;
+
+        // gets the storage for decoded strings
+        [[nodiscard]] internal::string_arena<json::char_type>& storage() noexcept { return *storage_; }
+
+        // gets/sets the root element
+        [[nodiscard]] const json_view& root() const noexcept { return root_; }
+        void set_root(json_view root) noexcept { root_ = std::move(root); }
+
+        // accesses the root element
+        [[nodiscard]] const json_view& operator *() const noexcept { return root_; }
+        [[nodiscard]] const json_view* operator ->() const noexcept { return &root_; }
+        [[nodiscard]] const json_view& operator [](json_view::js_array_index_view index) const noexcept { return root_[index]; } // array[index]
+        [[nodiscard]] const json_view& operator [](json_view::js_object_key_view key) const noexcept { return root_[key]; }    // object[key]
+        operator const json_view&() const noexcept { return root_; }
+    };
+
+    class json_tape_document;
+
+    /// json_tape_view: lightweight read-only reference to an element in json_tape_document.
+    /// Valid while the document lives (moving the document doesn't invalidate it).
+    class json_tape_view final
+    {
+    public: // typedefs
+        using char_type = json::char_type;
+        using js_null = json::js_null;
+        using js_boolean = json::js_boolean;
+        using js_integer = json::js_integer;
+        using js_floating = json::js_floating;
+        using js_number = json::js_number;
+        using js_string = json::js_string_view;
+        using js_array_index_view = json::js_array_index_view;
+        using js_object_key_view = json::js_object_key_view;
+
+        class const_iterator;
+
+    private:
+        const uint64_t* entry_{};     // tape entry of the element, nullptr if undefined
+        const char_type* strings_{};  // string storage of the document
+        friend class json_tape_document;
+
+        json_tape_view(const uint64_t* entry, const char_type* strings) noexcept : entry_(entry), strings_(strings) { }
+
+    public: // constructors
+        json_tape_view() = default; // undefined
+
+    public: // conversion
+        // makes a `json` owning copies of all values
+        [[nodiscard]] json to_json() const;
+
+    public: // accessors
+        [[nodiscard]] json_type_index get_type() const noexcept;
+
+        template <json_type_index TypeIndex> [[nodiscard]] bool is() const noexcept { return get_type() == TypeIndex; }
+        [[nodiscard]] bool is_defined() const noexcept { return entry_ != nullptr; }
+        [[nodiscard]] bool is_undefined() const noexcept { return entry_ == nullptr; }
+        [[nodiscard]] bool is_null() const noexcept { return is<json_type_index::null>(); }
+        [[nodiscard]] bool is_boolean() const noexcept { return is<json_type_index::boolean>(); }
+        [[nodiscard]] bool is_integer() const noexcept { return is<json_type_index::integer>(); }
+        [[nodiscard]] bool is_floating() const noexcept { return is<json_type_index::floating>(); }
+        [[nodiscard]] bool is_number() const noexcept { return is_integer() || is_floating(); }
+        [[nodiscard]] bool is_string() const noexcept { return is<json_type_index::string>(); }
+        [[nodiscard]] bool is_array() const noexcept { return is<json_type_index::array>(); }
+        [[nodiscard]] bool is_object() const noexcept { return is<json_type_index::object>(); }
+
+        // returns nullopt if type is mismatch
+        [[nodiscard]] std::optional<js_boolean> as_boolean() const noexcept;
+        [[nodiscard]] std::optional<js_integer> as_integer() const noexcept;
+        [[nodiscard]] std::optional<js_floating> as_floating() const noexcept;
+        [[nodiscard]] std::optional<js_number> as_number() const noexcept;
+        [[nodiscard]] std::optional<js_string> as_string() const noexcept;
+
+        // throws bad_access if type is mismatch
+        [[nodiscard]] js_null get_null() const { return is_null() ? js_null{} : throw bad_access(); }
+        [[nodiscard]] js_boolean get_boolean() const { return as_boolean() ? *as_boolean() : throw bad_access(); }
+        [[nodiscard]] js_integer get_integer() const { return as_integer() ? *as_integer() : throw bad_access(); }
+        [[nodiscard]] js_floating get_floating() const { return as_floating() ? *as_floating() : throw bad_access(); }
+        [[nodiscard]] js_number get_number() const { return as_number() ? *as_number() : throw bad_access(); }
+        [[nodiscard]] js_string get_string() const { return as_string() ? *as_string() : throw bad_access(); }
+
+        // returns default_value if type is mismatch
+        template <class U = js_boolean, std::enable_if_t<std::is_convertible_v<U, js_boolean>>* = nullptr> [[nodiscard]] js_boolean get_boolean_or(U&& default_value) const { return as_boolean().value_or(std::forward<U>(default_value)); }
+        template <class U = js_integer, std::enable_if_t<std::is_convertible_v<U, js_integer>>* = nullptr> [[nodiscard]] js_integer get_integer_or(U&& default_value) const { return as_integer().value_or(std::forward<U>(default_value)); }
+        template <class U = js_floating, std::enable_if_t<std::is_convertible_v<U, js_floating>>* = nullptr> [[nodiscard]] js_floating get_floating_or(U&& default_value) const { return as_floating().value_or(std::forward<U>(default_value)); }
+        template <class U = js_number, std::enable_if_t<std::is_convertible_v<U, js_number>>* = nullptr> [[nodiscard]] js_number get_number_or(U&& default_value) const { return as_number().value_or(std::forward<U>(default_value)); }
+        template <class U = js_string, std::enable_if_t<std::is_convertible_v<U, js_string>>* = nullptr> [[nodiscard]] js_string get_string_or(U&& default_value) const { return as_string().value_or(std::forward<U>(default_value)); }
+
+    public: // containers
+        // gets the number of elements of array or members of object (0 for others)
+        [[nodiscard]] size_t size() const noexcept;
+
+        // finds the element, returns undefined if not found
+        [[nodiscard]] json_tape_view operator [](js_array_index_view index) const noexcept; // array[index]
+        [[nodiscard]] json_tape_view operator [](js_object_key_view key) const noexcept;    // object[key]
+
+        // iterates elements of array or members of object
+        [[nodiscard]] const_iterator begin() const noexcept;
+        [[nodiscard]] const_iterator end() const noexcept;
+    };
+
+    /// json_tape_document: immutable json document stored in a flat array of 64-bit entries and a string storage.
+    /// Each entry has a type tag in its upper 8 bits and a payload in the rest:
+    ///   null, false, true:  [tag]
+    ///   integer, floating:  [tag] [value...]
+    ///   string:             [tag | offset in the string storage] [length]
+    ///   array, object:      [tag | distance to the next of the end entry] [count] elements... [end tag | distance to the start entry]
+    /// Object members are pairs of a string entry (the key) and the value.
+    class json_tape_document final
+    {
+    public:
+        using char_type = json::char_type;
+
+        enum struct tape_tag : uint64_t
+        {
+            null,
+            boolean_false,
+            boolean_true,
+            integer,
+            floating,
+            string,
+            start_array,
+            end_array,
+            start_object,
+            end_object,
+        };
+
+        static constexpr int tag_shift = 56;
+        static constexpr uint64_t payload_mask = (uint64_t{1} << tag_shift) - 1;
+        static constexpr size_t floating_entries = (sizeof(json::js_floating) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+        [[nodiscard]] static constexpr uint64_t make_entry(tape_tag tag, uint64_t payload = 0) noexcept { return static_cast<uint64_t>(tag) << tag_shift | payload; }
+        [[nodiscard]] static constexpr tape_tag tag_of(uint64_t entry) noexcept { return static_cast<tape_tag>(entry >> tag_shift); }
+        [[nodiscard]] static constexpr uint64_t payload_of(uint64_t entry) noexcept { return entry & payload_mask; }
+
+        // gets the number of entries of the element at `entry` (including its children)
+        [[nodiscard]] static size_t element_size(const uint64_t* entry) noexcept
+        {
+            switch (tag_of(*entry))
+            {
+            case tape_tag::integer: return 2;
+            case tape_tag::floating: return 1 + floating_entries;
+            case tape_tag::string: return 2;
+            case tape_tag::start_array: return static_cast<size_t>(payload_of(*entry));
+            case tape_tag::start_object: return static_cast<size_t>(payload_of(*entry));
+            default: return 1;
+            }
+        }
+
+    private:
+        std::vector<uint64_t> tape_{};
+        std::vector<char_type> strings_{}; // strings are not null-terminated
+        friend class json_tape_builder;
+
+    public:
+        json_tape_document() = default;
+        json_tape_document(const json_tape_document& other) = delete;
+        json_tape_document(json_tape_document&& other) noexcept = default;
+        json_tape_document& operator=(const json_tape_document& other) = delete;
+        json_tape_document& operator=(json_tape_document&& other) noexcept = default;
+        ~json_tape_document() = default;
+
+        // gets the root element
+        [[nodiscard]] json_tape_view root() const noexcept { return tape_.empty() ? json_tape_view{} : json_tape_view(tape_.data(), strings_.data()); }
+
+        // accesses the root element
+        [[nodiscard]] json_tape_view operator *() const noexcept { return root(); }
+        [[nodiscard]] json_tape_view operator [](json_tape_view::js_array_index_view index) const noexcept { return root()[index]; } // array[index]
+        [[nodiscard]] json_tape_view operator [](json_tape_view::js_object_key_view key) const noexcept { return root()[key]; }    // object[key]
+
+        // gets the tape and the string storage
+        [[nodiscard]] const std::vector<uint64_t>& tape() const noexcept { return tape_; }
+        [[nodiscard]] const std::vector<char_type>& strings() const noexcept { return strings_; }
+    };
+
+    // iterates elements of array or members of object in json_tape_view
+    class json_tape_view::const_iterator
+    {
+        using tape_tag = json_tape_document::tape_tag;
+
+        const uint64_t* entry_{}; // the element (for array), or the key (for object)
+        const char_type* strings_{};
+        bool object_{};
+        friend class json_tape_view;
+
+        const_iterator(const uint64_t* entry, const char_type* strings, bool object) noexcept : entry_(entry), strings_(strings), object_(object) { }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = json_tape_view;
+        using difference_type = ptrdiff_t;
+        using pointer = void;
+        using reference = json_tape_view;
+
+        const_iterator() = default;
+
+        // gets the element (for array) or the member value (for object)
+        [[nodiscard]] json_tape_view operator *() const noexcept { return json_tape_view(object_ ? entry_ + 2 : entry_, strings_); }
+
+        // gets the member key (for object)
+        [[nodiscard]] js_string key() const noexcept { return object_ ? json_tape_view(entry_, strings_).get_string_or(js_string{}) : js_string{}; }
+
+        const_iterator& operator ++() noexcept
+        {
+            entry_ = object_ ? entry_ + 2 + json_tape_document::element_size(entry_ + 2) : entry_ + json_tape_document::element_size(entry_);
+            return *this;
+        }
+
+        const_iterator operator ++(int) noexcept
+        {
+            const_iterator r = *this;
+            ++*this;
+            return r;
+        }
+
+        friend bool operator ==(const const_iterator& lhs, const const_iterator& rhs) noexcept { return lhs.entry_ == rhs.entry_; }
+        friend bool operator !=(const const_iterator& lhs, const const_iterator& rhs) noexcept { return lhs.entry_ != rhs.entry_; }
+    };
+
+    inline json_type_index json_tape_view::get_type() const noexcept
+    {
+        using tape_tag = json_tape_document::tape_tag;
+        if (!entry_) return json_type_index::undefined;
+        switch (json_tape_document::tag_of(*entry_))
+        {
+        case tape_tag::null: return json_type_index::null;
+        case tape_tag::boolean_false: return json_type_index::boolean;
+        case tape_tag::boolean_true: return json_type_index::boolean;
+        case tape_tag::integer: return json_type_index::integer;
+        case tape_tag::floating: return json_type_index::floating;
+        case tape_tag::string: return json_type_index::string;
+        case tape_tag::start_array: return json_type_index::array;
+        case tape_tag::start_object: return json_type_index::object;
+        default: return json_type_index::undefined;
+        }
+    }
+
+    inline std::optional<json::js_boolean> json_tape_view::as_boolean() const noexcept
+    {
+        if (!is_boolean()) return std::nullopt;
+        return json_tape_document::tag_of(*entry_) == json_tape_document::tape_tag::boolean_true;
+    }
+
+    inline std::optional<json::js_integer> json_tape_view::as_integer() const noexcept
+    {
+        if (!is_integer()) return std::nullopt;
+        return static_cast<js_integer>(entry_[1]);
+    }
+
+    inline std::optional<json::js_floating> json_tape_view::as_floating() const noexcept
+    {
+        if (!is_floating()) return std::nullopt;
+        js_floating r{};
+        std::memcpy(&r, entry_ + 1, sizeof(r));
+        return r;
+    }
+
+    inline std::optional<json::js_number> json_tape_view::as_number() const noexcept
+    {
+        if (const auto num = as_integer()) return static_cast<js_number>(*num);
+        if (const auto num = as_floating()) return static_cast<js_number>(*num);
+        return std::nullopt;
+    }
+
+    inline std::optional<json::js_string_view> json_tape_view::as_string() const noexcept
+    {
+        if (!is_string()) return std::nullopt;
+        return js_string(strings_ + json_tape_document::payload_of(entry_[0]), static_cast<size_t>(entry_[1]));
+    }
+
+    inline size_t json_tape_view::size() const noexcept
+    {
+        return is_array() || is_object() ? static_cast<size_t>(entry_[1]) : 0;
+    }
+
+    inline json_tape_view::const_iterator json_tape_view::begin() const noexcept
+    {
+        return is_array() || is_object() ? const_iterator(entry_ + 2, strings_, is_object()) : const_iterator{};
+    }
+
+    inline json_tape_view::const_iterator json_tape_view::end() const noexcept
+    {
+        return is_array() || is_object() ? const_iterator(entry_ + json_tape_document::element_size(entry_) - 1, strings_, is_object()) : const_iterator{};
+    }
+
+    // array[index]: skips preceding elements
+    inline json_tape_view json_tape_view::operator[](js_array_index_view index) const noexcept
+    {
+        if (!is_array() || index >= size()) return {};
+        auto it = begin();
+        while (index--) ++it;
+        return *it;
+    }
+
+    // object[key]: compares keys, skipping values. the last one wins if the key is duplicated (same as `json`).
+    inline json_tape_view json_tape_view::operator[](js_object_key_view key) const noexcept
+    {
+        json_tape_view r{};
+        if (!is_object()) return r;
+        for (auto it = begin(), e = end(); it != e; ++it)
+            if (it.key().compare(key) == 0) r = *it; // (not `==`, which would consider `operator ==(const json&, const json&)`)
+        return r;
+    }
+
+    // input/output
+
+    /// json_event_handler: the interface of handlers receiving json_reader events, with empty default implementations.
+    /// Handlers don't have to derive from this (the events are called statically), but deriving lets them define only the needed events.
+    /// Strings given to `on_string` and `on_key` are valid only during the call.
+    /// With `json_parse_option::raw_number`, handlers defining `on_raw_number(js_string_view)` receive number text instead of `on_integer`/`on_floating`.
+    /// Handlers defining `on_key(js_string_view, size_t offset)` receive the offset of the key in the source text too (e.g. to report duplicate keys).
+    struct json_event_handler
+    {
+        void on_null() { }
+        void on_boolean(json::js_boolean) { }
+        void on_integer(json::js_integer) { }
+        void on_floating(json::js_floating) { }
+        void on_string(json::js_string_view) { }
+        void on_key(json::js_string_view) { } // object member key, followed by the value
+        void on_start_array() { }
+        void on_end_array(size_t /* count */) { }
+        void on_start_object() { }
+        void on_end_object(size_t /* count */) { }
+    };
+
+    // builds a tree of `Node` (`json` or `json_view`) from json_reader events
+    template <class Node>
+    class json_document_builder
+    {
+        using js_string = typename Node::js_string;
+        using js_string_view = typename Node::js_string_view;
+        using js_array = typename Node::js_array;
+        using js_object = typename Node::js_object;
+        using js_object_key = typename Node::js_object_key;
+
+        std::vector<Node> containers_{};                         // arrays and objects under construction
+        std::vector<std::pair<js_object_key, Node>> members_{}; // members of the objects under construction
+        std::vector<size_t> member_bases_{};                     // the first index in `members_` of each object under construction
+        std::vector<size_t> key_table_{};                        // hash table (index in `members_` + 1) to find duplicate keys
+        std::vector<size_t> key_offsets_{};                      // offsets of the keys in `members_` in the source text, if rejecting duplicate keys
+        json_parse_option option_bits_{};
+        Node result_{};
+
+        // emptied containers to reuse, keeping their capacity (see `recycle`)
+        std::vector<js_array> spare_arrays_{};
+        std::vector<js_object> spare_objects_{};
+        std::vector<Node*> recycling_{};
+
+        // for `json_view`: strings outside of `source_` (i.e. decoded into the reader's buffer) are copied into `storage_`
+        js_string_view source_{};
+        internal::string_arena<typename Node::char_type>* storage_{};
+        internal::string_interner<typename Node::char_type> key_interner_{}; // for `json_view`: interns object keys into `storage_` if enabled
+
+        // makes an object key from the reader's string
+        js_object_key make_key(js_string_view s)
+        {
+            if constexpr (std::is_same_v<js_object_key, js_string_view>)
+                if (key_interner_.enabled()) return key_interner_.intern(s);
+            return make_string(s);
+        }
+
+        // makes a string value from the reader's string
+        js_string make_string(js_string_view s)
+        {
+            if constexpr (std::is_same_v<js_string, js_string_view>)
+            {
+                constexpr std::less<const typename Node::char_type*> less{};
+                if (storage_ && (less(s.data(), source_.data()) || less(source_.data() + source_.size(), s.data() + s.size())))
+                    return storage_->store(s);
+                return s;
+            }
+            else
+            {
+                return js_string(s);
+            }
+        }
+
+        // puts a completed value into the current container
+        void put(Node&& value)
+        {
+            if (containers_.empty())
+                result_ = std::move(value);
+            else if (js_array* a = std::get_if<js_array>(&containers_.back().value_))
+            {
+                if (a->capacity() == 0) a->reserve(8); // on the first element, as empty arrays allocate nothing
+                a->push_back(std::move(value));
+            }
+            else
+                members_.back().second = std::move(value);
+        }
+
+        // removes the members with duplicate keys in `members_[base, end)` as `option_bits_` specifies,
+        // keeping the order of the first occurrences. uses hash table for large objects.
+        void remove_duplicate_keys(size_t base)
+        {
+            const size_t count = members_.size() - base;
+            if (count < 2) return;
+
+            const bool hashed = count > 16;
+            size_t mask = 0;
+            if (hashed)
+            {
+                size_t table_size = 64;
+                while (table_size < count * 2) table_size *= 2;
+                key_table_.assign(table_size, 0);
+                mask = table_size - 1;
+            }
+
+            size_t kept = base; // end of the members kept
+            for (size_t i = base; i < members_.size(); i++)
+            {
+                const js_string_view key = members_[i].first;
+                size_t* empty_slot = nullptr;
+                size_t found = members_.size();
+                if (hashed)
+                {
+                    for (size_t h = std::hash<js_string_view>{}(key) & mask;; h = (h + 1) & mask)
+                    {
+                        if (key_table_[h] == 0) { empty_slot = &key_table_[h]; break; }
+                        if (js_string_view(members_[key_table_[h] - 1].first).compare(key) == 0) { found = key_table_[h] - 1; break; }
+                    }
+                }
+                else
+                {
+                    for (size_t j = base; j < kept; j++)
+                        if (js_string_view(members_[j].first).compare(key) == 0) { found = j; break; }
+                }
+
+                if (found == members_.size()) // new key
+                {
+                    if (kept != i) members_[kept] = std::move(members_[i]);
+                    if (empty_slot) *empty_slot = kept + 1;
+                    kept++;
+                }
+                else if (rejects_duplicate_key())
+                    throw json::json_reader<const typename Node::char_type*>::make_bad_format(
+                        "invalid object format: duplicate key \"" + std::string(key.begin(), key.end()) + "\"", std::nullopt, std::nullopt, key_offsets_[i]);
+                else if ((option_bits_ & json_parse_option::keep_first_duplicate_key) == json_parse_option::none)
+                    members_[found].second = std::move(members_[i].second);
+            }
+
+            members_.erase(members_.begin() + static_cast<std::ptrdiff_t>(kept), members_.end());
+        }
+
+        [[nodiscard]] bool rejects_duplicate_key() const noexcept { return (option_bits_ & json_parse_option::reject_duplicate_key) != json_parse_option::none; }
+
+    public:
+        json_document_builder() = default;
+
+        // `option` specifies how to treat duplicate object keys
+        explicit json_document_builder(json_parse_option option) : option_bits_(option) { }
+
+        // for `json_view`: strings not in `source` are copied into `storage`
+        json_document_builder(js_string_view source, internal::string_arena<typename Node::char_type>* storage, json_parse_option option = json_parse_option::default_option)
+            : option_bits_(option), source_(source), storage_(storage) { }
+
+        // for `json_view`: all strings are copied into `storage`, and equal object keys share one copy
+        json_document_builder(internal::string_arena<typename Node::char_type>* storage, json_parse_option option)
+            : option_bits_(option), storage_(storage), key_interner_(storage) { }
+
+        // gets built tree
+        [[nodiscard]] Node result() { return std::move(result_); }
+
+        // discards the tree under construction (after an error), to build next one.
+        void reset()
+        {
+            containers_.clear();
+            members_.clear();
+            member_bases_.clear();
+            key_offsets_.clear();
+            result_ = Node{};
+        }
+
+        // takes arrays and objects in `node` to reuse their capacity in the following trees.
+        void recycle(Node&& node)
+        {
+            // lists containers in pre-order, then empties them in reverse (children first)
+            recycling_.clear();
+            recycling_.push_back(&node);
+            for (size_t i = 0; i < recycling_.size(); i++)
+            {
+                if (js_array* a = std::get_if<js_array>(&recycling_[i]->value_))
+                    for (auto& e : *a) if (e.is_array() || e.is_object()) recycling_.push_back(&e);
+                if (js_object* o = std::get_if<js_object>(&recycling_[i]->value_))
+                    for (auto& kv : *o) if (kv.second.is_array() || kv.second.is_object()) recycling_.push_back(&kv.second);
+            }
+
+            for (auto it = recycling_.rbegin(); it != recycling_.rend(); ++it)
+            {
+                if (js_array* a = std::get_if<js_array>(&(*it)->value_))
+                {
+                    a->clear();
+                    spare_arrays_.push_back(std::move(*a));
+                }
+                else if (js_object* o = std::get_if<js_object>(&(*it)->value_))
+                {
+                    o->clear();
+                    spare_objects_.push_back(std::move(*o));
+                }
+            }
+            recycling_.clear();
+        }
+
+        void on_null() { put(Node(in_place_index::null)); }
+        void on_boolean(typename Node::js_boolean value) { put(Node(in_place_index::boolean, value)); }
+        void on_integer(typename Node::js_integer value) { put(Node(in_place_index::integer, value)); }
+        void on_floating(typename Node::js_floating value) { put(Node(in_place_index::floating, value)); }
+        void on_string(js_string_view value) { put(Node(in_place_index::string, make_string(value))); }
+        void on_raw_number(js_string_view text) { put(Node(in_place_index::raw_number, make_string(text))); }
+        void on_key(js_string_view key, size_t offset) // `offset`: of the key in the source text, reported if the key is rejected as duplicate
+        {
+            members_.emplace_back(make_key(key), Node{});
+            if (rejects_duplicate_key()) key_offsets_.push_back(offset);
+        }
+        void on_value(Node&& value) { put(std::move(value)); } // puts a value made by the caller (e.g. json_lazy_view not read yet)
+
+        void on_start_array() { containers_.emplace_back(in_place_index::array, take_spare(spare_arrays_)); }
+
+        void on_start_object()
+        {
+            containers_.emplace_back(in_place_index::object, take_spare(spare_objects_));
+            member_bases_.push_back(members_.size());
+        }
+
+        void on_end_array(size_t) { on_end_container(); }
+
+        void on_end_object(size_t)
+        {
+            // appends members without lookup, after removing duplicate keys.
+            const size_t base = member_bases_.back();
+            member_bases_.pop_back();
+            remove_duplicate_keys(base);
+
+            js_object& object = std::get<js_object>(containers_.back().value_);
+            object.reserve(members_.size() - base);
+            for (size_t i = base; i < members_.size(); i++) object.append_unchecked(std::move(members_[i]));
+            members_.erase(members_.begin() + static_cast<std::ptrdiff_t>(base), members_.end());
+            if (rejects_duplicate_key()) key_offsets_.resize(base);
+
+            on_end_container();
+        }
+
+    private:
+        void on_end_container()
+        {
+            Node value = std::move(containers_.back());
+            containers_.pop_back();
+            put(std::move(value));
+        }
+
+        // takes an emptied container from `spares`, or makes new one (without allocation)
+        template <class Container>
+        static Container take_spare(std::vector<Container>& spares)
+        {
+            if (spares.empty()) return Container{};
+
+            Container c = std::move(spares.back());
+            spares.pop_back();
+            return c;
+        }
+    };
+
+    // notifies the elements of read-only `node` (json_view, json_tape_view or json_lazy_view) to `builder`
+    template <class Node>
+    void copy_json_element(const Node& node, json_document_builder<json>& builder)
+    {
+        switch (node.get_type())
+        {
+        case json_type_index::undefined: return builder.on_value(json{});
+        case json_type_index::null: return builder.on_null();
+        case json_type_index::boolean: return builder.on_boolean(node.get_boolean());
+        case json_type_index::integer: return builder.on_integer(node.get_integer());
+        case json_type_index::floating: return builder.on_floating(node.get_floating());
+        case json_type_index::string: return builder.on_string(node.get_string());
+        case json_type_index::raw_number:
+            if constexpr (!std::is_same_v<Node, json_tape_view>) builder.on_raw_number(node.as_raw_number()->text()); // (tapes hold converted numbers)
+            return;
+        case json_type_index::array:
+            builder.on_start_array();
+            if constexpr (std::is_same_v<Node, json_tape_view>) for (auto&& e : node) copy_json_element(e, builder);
+            else for (auto&& e : *node.as_array()) copy_json_element(e, builder);
+            return builder.on_end_array(0);
+        case json_type_index::object:
+            builder.on_start_object();
+            if constexpr (std::is_same_v<Node, json_tape_view>) for (auto it = node.begin(), e = node.end(); it != e; ++it) builder.on_key(it.key(), 0), copy_json_element(*it, builder);
+            else for (auto&& [k, v] : *node.as_object()) builder.on_key(k, 0), copy_json_element(v, builder);
+            return builder.on_end_object(0);
+        }
+    }
+
+    // makes a `json` owning copies of all values of read-only `node` (json_view, json_tape_view or json_lazy_view).
+    // object members are appended without lookup (the last one wins if a key is duplicated, as `parse_json`).
+    template <class Node>
+    json copy_json(const Node& node)
+    {
+        json_document_builder<json> builder{};
+        copy_json_element(node, builder);
+        return builder.result();
+    }
+
+    inline json json_view::to_json() const { return copy_json(*this); }
+    inline json json_tape_view::to_json() const { return copy_json(*this); }
+
+    // builds json_tape_document from json_reader events
+    class json_tape_builder
+    {
+        using tape_tag = json_tape_document::tape_tag;
+
+        json_tape_document document_{};
+        std::vector<size_t> containers_{}; // start entries of arrays and objects under construction
+
+        // interning table of object keys: (offset in string storage, size), open addressing (free slots have size 0)
+        std::vector<std::pair<size_t, size_t>> key_table_{};
+        size_t key_count_{};
+
+        // gets the offset of `key` in the string storage, storing it if not yet (equal keys share one copy)
+        size_t intern_key(json::js_string_view key)
+        {
+            auto& strings = document_.strings_;
+            if (key.empty()) return strings.size();
+
+            if ((key_count_ + 1) * 2 > key_table_.size())
+            {
+                std::vector<std::pair<size_t, size_t>> old((std::max)(key_table_.size() * 2, size_t{64}));
+                old.swap(key_table_);
+                key_count_ = 0;
+                for (const auto& [offset, size] : old)
+                    if (size != 0) *find_key_slot(json::js_string_view(strings.data() + offset, size)) = {offset, size}, ++key_count_;
+            }
+
+            auto* slot = find_key_slot(key);
+            if (slot->second == 0)
+            {
+                *slot = {strings.size(), key.size()};
+                strings.insert(strings.end(), key.begin(), key.end());
+                ++key_count_;
+            }
+            return slot->first;
+        }
+
+        // finds the slot of `key`, or a free slot to store it
+        std::pair<size_t, size_t>* find_key_slot(json::js_string_view key)
+        {
+            const size_t mask = key_table_.size() - 1;
+            for (size_t h = std::hash<json::js_string_view>{}(key) & mask;; h = (h + 1) & mask)
+            {
+                auto& slot = key_table_[h];
+                if (slot.second == 0 || json::js_string_view(document_.strings_.data() + slot.first, slot.second).compare(key) == 0) return &slot;
+            }
+        }
+
+    public:
+        // gets built document
+        [[nodiscard]] json_tape_document result() { return std::move(document_); }
+
+        void on_null() { document_.tape_.push_back(json_tape_document::make_entry(tape_tag::null)); }
+        void on_boolean(json::js_boolean value) { document_.tape_.push_back(json_tape_document::make_entry(value ? tape_tag::boolean_true : tape_tag::boolean_false)); }
+
+        void on_integer(json::js_integer value)
+        {
+            document_.tape_.push_back(json_tape_document::make_entry(tape_tag::integer));
+            document_.tape_.push_back(static_cast<uint64_t>(value));
+        }
+
+        void on_floating(json::js_floating value)
+        {
+            auto& tape = document_.tape_;
+            tape.push_back(json_tape_document::make_entry(tape_tag::floating));
+            tape.resize(tape.size() + json_tape_document::floating_entries);
+            std::memcpy(tape.data() + tape.size() - json_tape_document::floating_entries, &value, sizeof(value));
+        }
+
+        void on_string(json::js_string_view value)
+        {
+            document_.tape_.push_back(json_tape_document::make_entry(tape_tag::string, document_.strings_.size()));
+            document_.tape_.push_back(value.size());
+            document_.strings_.insert(document_.strings_.end(), value.begin(), value.end());
+        }
+
+        void on_key(json::js_string_view key)
+        {
+            document_.tape_.push_back(json_tape_document::make_entry(tape_tag::string, intern_key(key)));
+            document_.tape_.push_back(key.size());
+        }
+
+        void on_start_array() { on_start_container(tape_tag::start_array); }
+        void on_start_object() { on_start_container(tape_tag::start_object); }
+        void on_end_array(size_t count) { on_end_container(tape_tag::start_array, tape_tag::end_array, count); }
+        void on_end_object(size_t count) { on_end_container(tape_tag::start_object, tape_tag::end_object, count); }
+
+    private:
+        void on_start_container(tape_tag start)
+        {
+            containers_.push_back(document_.tape_.size());
+            document_.tape_.push_back(json_tape_document::make_entry(start));
+            document_.tape_.push_back(0); // count
+        }
+
+        // fills the skip distance and the count of start entry
+        void on_end_container(tape_tag start, tape_tag end, size_t count)
+        {
+            auto& tape = document_.tape_;
+            const size_t begin = containers_.back();
+            containers_.pop_back();
+            tape.push_back(json_tape_document::make_entry(end, tape.size() - begin));
+            tape[begin] = json_tape_document::make_entry(start, tape.size() - begin);
+            tape[begin + 1] = count;
+        }
+    };
+
+    template <class CharInputIterator>
+    class json_cursor;
+
+    template <class Handler>
+    class json_push_parser;
+
+    class json_parser;
+
+    class json_lazy_view;
+
+    class json_lines_reader;
+
+    template <class CharInputIterator>
+    struct json::json_reader
+    {
+    private:
+        friend class json_cursor<CharInputIterator>;
+        template <class Handler> friend class json_push_parser;
+        friend class json_parser;
+        friend class json_lazy_view;
+        friend class json_lines_reader;
+        template <class Node> friend class json_document_builder;
+
+        using char_traits = typename json::char_traits;
+        using char_type = typename char_traits::char_type;
+        using int_type = typename char_traits::int_type;
+        static constexpr bool is_contiguous_input = std::is_pointer_v<CharInputIterator> && std::is_same_v<std::remove_cv_t<std::remove_pointer_t<CharInputIterator>>, char_type>;
+
+    public:
+        // reads json, rejecting arrays and objects nested deeper than `max_depth`.
+        static json read_json(CharInputIterator begin, CharInputIterator end, json_parse_option loose_option, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            json_document_builder<json> builder(loose_option);
+            json_reader reader(std::move(begin), std::move(end), loose_option);
+            reader.max_depth_ = max_depth;
+            reader.execute(builder);
+            return builder.result();
+        }
+
+        // reads json and notifies elements to `handler` (see `json_event_handler`), rejecting arrays and objects nested deeper than `max_depth`.
+        template <class Handler>
+        static void read_json(CharInputIterator begin, CharInputIterator end, json_parse_option loose_option, Handler& handler, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            json_reader reader(std::move(begin), std::move(end), loose_option);
+            reader.max_depth_ = max_depth;
+            reader.execute(handler);
+        }
+
+        // reads json from mutable buffer `[begin, end)` and notifies elements to `handler`.
+        // escape sequences in strings are decoded in place, so every string given to `handler` refers to the buffer.
+        template <class Handler, bool contiguous = is_contiguous_input, std::enable_if_t<contiguous>* = nullptr>
+        static void read_json_in_situ(char_type* begin, char_type* end, json_parse_option loose_option, Handler& handler, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            json_reader reader(begin, end, loose_option);
+            reader.max_depth_ = max_depth;
+            reader.in_situ_begin_ = begin;
+            reader.execute(handler);
+        }
+
+        // reads json from `[begin, end)` in two stages and notifies elements to `handler`:
+        // finds structural characters in whole input first, then reads elements jumping between them.
+        // returns false without reading, if `loose_option` needs byte-by-byte reading (`allow_comment`, `allow_unquoted_object_key`) or the input is too large.
+        // on malformed input, throws bad_format which may differ from the one `read_json` throws.
+        template <class Handler, bool contiguous = is_contiguous_input, std::enable_if_t<contiguous>* = nullptr>
+        static bool read_json_indexed(const char_type* begin, const char_type* end, json_parse_option loose_option, Handler& handler, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            constexpr json_parse_option unsupported = json_parse_option::allow_comment | json_parse_option::allow_unquoted_object_key;
+            if ((loose_option & unsupported) != json_parse_option::none) return false;
+            if (static_cast<size_t>(end - begin) > (std::numeric_limits<uint32_t>::max)()) return false;
+
+            json_reader reader(begin, end, loose_option);
+            reader.max_depth_ = max_depth;
+            reader.eat_utf8bom();
+
+            std::vector<uint32_t> index;
+            internal::scan::build_structural_index(begin, reader.input_.it_, end, index);
+            reader.index_ = index.data();
+            reader.index_end_ = index.data() + index.size();
+
+            reader.next_structural();
+            reader.read_element_indexed(handler);
+            return true;
+        }
+
+        // reads json whose root is an array from `[begin, end)`: finds the elements of the root array with quote-aware scan first,
+        // then reads them on `thread_count` threads (0: the number of hardware threads).
+        // returns nullopt without reading, if the root is not a closed array, or `loose_option` needs byte-by-byte reading (`allow_comment`, `allow_unquoted_object_key`).
+        // on malformed input, throws bad_format which may differ from the one `read_json` throws.
+        template <bool contiguous = is_contiguous_input, std::enable_if_t<contiguous>* = nullptr>
+        static std::optional<json> read_json_parallel(const char_type* begin, const char_type* end, json_parse_option loose_option, size_t thread_count, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            constexpr json_parse_option unsupported = json_parse_option::allow_comment | json_parse_option::allow_unquoted_object_key;
+            if ((loose_option & unsupported) != json_parse_option::none) return std::nullopt;
+
+            json_reader reader(begin, end, loose_option);
+            reader.eat_utf8bom();
+            reader.eat_whitespaces();
+            if (*reader.input_ != '[') return std::nullopt;
+            if (max_depth == 0) return std::nullopt; // the root array is too deep (reported by `read_json`)
+
+            // `[`, `,`s and `]` of the root array
+            std::vector<const char_type*> delimiters{reader.input_.it_};
+            if (!internal::scan::split_array_elements(reader.input_.it_, end, delimiters) || *delimiters.back() != ']') return std::nullopt;
+
+            auto is_blank = [&](size_t i) { return internal::scan::skip_whitespaces(delimiters[i] + 1, delimiters[i + 1]) == delimiters[i + 1]; };
+            size_t count = delimiters.size() - 1;
+            if (count == 1 && is_blank(0)) count = 0;                                                                       // `[]`
+            else if (count > 1 && reader.has_option(json_parse_option::allow_trailing_comma) && is_blank(count - 1)) count--; // `[...,]`
+
+            constexpr size_t batch_size = 64; // elements taken by a worker at once
+            const size_t batch_count = (count + batch_size - 1) / batch_size;
+
+            js_array elements(count);
+            std::atomic<size_t> next{0};
+            internal::run_parallel((std::min)(internal::worker_thread_count(thread_count), (std::max)(batch_count, size_t{1})), [&](const std::atomic<bool>& cancelled)
+            {
+                for (size_t first; !cancelled && (first = next.fetch_add(batch_size)) < count;)
+                {
+                    for (size_t i = first, last = (std::min)(first + batch_size, count); i < last; i++)
+                    {
+                        json_document_builder<json> builder(loose_option);
+                        read_json_element(begin, delimiters[i] + 1, delimiters[i + 1], loose_option, builder, 1, max_depth);
+                        elements[i] = builder.result();
+                    }
+                }
+            });
+            return json(std::move(elements));
+        }
+
+        // reads an element in `[begin, end)` surrounded by white spaces, a part of source text starting at `base`, and notifies it to `handler`.
+        // `depth` is the number of containers enclosing the element in the source text, counted toward `max_depth`.
+        // throws bad_format (with the offset from `base`) if other characters follow the element.
+        template <class Handler, bool contiguous = is_contiguous_input, std::enable_if_t<contiguous>* = nullptr>
+        static void read_json_element(const char_type* base, const char_type* begin, const char_type* end, json_parse_option loose_option, Handler& handler, size_t depth = 0, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            json_reader reader(begin, end, loose_option);
+            reader.offset_base_ = static_cast<size_t>(begin - base);
+            reader.depth_ = depth;
+            reader.max_depth_ = max_depth;
+            reader.eat_whitespaces();
+            reader.read_element(handler);
+            reader.eat_whitespaces();
+            if (*reader.input_ != EOF) throw reader.bad_format("invalid json format: unexpected character after an element", *reader.input_);
+        }
+
+        // reads a number in `[begin, end)` (such as the text of js_raw_number) and notifies it to `handler` as integer or floating.
+        template <class Handler, bool contiguous = is_contiguous_input, std::enable_if_t<contiguous>* = nullptr>
+        static void read_json_number(const char_type* begin, const char_type* end, Handler& handler)
+        {
+            json_reader reader(begin, end, json_parse_option::none);
+            reader.read_number(handler);
+            if (*reader.input_ != EOF) throw reader.bad_format("invalid number format: unexpected character after a number", *reader.input_);
+        }
+
+    private:
+        // position in source text (0-origin)
+        struct source_position
+        {
+            size_t line{};
+            size_t column{};
+        };
+
+        // computes line/column of the end of `[begin, begin + offset)`
+        template <class Iterator>
+        [[nodiscard]] static source_position scan_position(Iterator begin, size_t offset)
+        {
+            source_position r{};
+            for (Iterator p = begin; offset != 0; ++p, --offset)
+            {
+                if (*p == '\n') r.line++, r.column = 0;
+                else r.column++;
+            }
+            return r;
+        }
+
+        // input stream over generic iterator pair
+        // counts consumed characters only. line/column is computed by rescanning the input when it is requested,
+        // or (for single-pass input) tracked only if NANOJSON3_TRACK_SOURCE_LINE is enabled.
+        struct generic_input_stream
+        {
+            static constexpr bool is_multi_pass = std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<CharInputIterator>::iterator_category>;
+            static constexpr bool tracks_line = !is_multi_pass && NANOJSON3_TRACK_SOURCE_LINE;
+
+            CharInputIterator const begin_;
+            CharInputIterator it_;
+            CharInputIterator const end_;
+
+            size_t current_offset_{};
+            size_t current_line_{};        // used if tracks_line
+            size_t current_line_offset_{}; // used if tracks_line
+
+            generic_input_stream(CharInputIterator begin, CharInputIterator end) : begin_(begin), it_(std::move(begin)), end_(std::move(end)) { }
+
+            // gets current offset
+            [[nodiscard]] size_t offset() const
+            {
+                return current_offset_;
+            }
+
+            // gets current position if available
+            [[nodiscard]] std::optional<source_position> position() const
+            {
+                if constexpr (is_multi_pass) return scan_position(begin_, current_offset_);
+                else if constexpr (tracks_line) return source_position{current_line_, current_offset_ - current_line_offset_};
+                else return std::nullopt;
+            }
+
+            // peeks current character
+            [[nodiscard]] int_type peek() const
+            {
+                return it_ != end_ ? char_traits::to_int_type(*it_) : char_traits::eof();
+            }
+
+            // eats a character
+            [[nodiscard]] int_type eat()
+            {
+                const int_type i = peek();
+                if (it_ != end_)
+                {
+                    ++it_;
+                    ++current_offset_;
+
+                    if constexpr (tracks_line)
+                    {
+                        if (i == '\n')
+                        {
+                            current_line_++;
+                            current_line_offset_ = current_offset_;
+                        }
+                    }
+                }
+
+                return i;
+            }
+
+            // eats if current character is `chr`
+            [[nodiscard]] bool eat(int_type chr)
+            {
+                return peek() == chr ? (void)eat(), true : false;
+            }
+
+            int_type operator *() const
+            {
+                return peek();
+            }
+
+            generic_input_stream& operator ++()
+            {
+                return (void)eat(), *this;
+            }
+
+            auto operator ++(int)
+            {
+                struct iter
+                {
+                    int_type value;
+                    int_type operator *() const { return value; }
+                };
+
+                return iter{eat()};
+            }
+        };
+
+        // input stream over contiguous memory `[begin, end)`
+        // works on raw pointers, and computes line/column only when it is requested.
+        struct contiguous_input_stream
+        {
+            const char_type* const begin_;
+            const char_type* it_;
+            const char_type* const end_;
+
+            contiguous_input_stream(const char_type* begin, const char_type* end) : begin_(begin), it_(begin), end_(end) { }
+
+            // gets current offset
+            [[nodiscard]] size_t offset() const
+            {
+                return static_cast<size_t>(it_ - begin_);
+            }
+
+            // gets current position (scans consumed text)
+            [[nodiscard]] std::optional<source_position> position() const
+            {
+                return scan_position(begin_, offset());
+            }
+
+            // peeks current character
+            [[nodiscard]] int_type peek() const
+            {
+                return it_ != end_ ? char_traits::to_int_type(*it_) : char_traits::eof();
+            }
+
+            // eats a character
+            [[nodiscard]] int_type eat()
+            {
+                return it_ != end_ ? char_traits::to_int_type(*it_++) : char_traits::eof();
+            }
+
+            // eats if current character is `chr`
+            [[nodiscard]] bool eat(int_type chr)
+            {
+                return it_ != end_ && char_traits::to_int_type(*it_) == chr ? (void)++it_, true : false;
+            }
+
+            int_type operator *() const
+            {
+                return peek();
+            }
+
+            contiguous_input_stream& operator ++()
+            {
+                if (it_ != end_) ++it_;
+                return *this;
+            }
+
+            auto operator ++(int)
+            {
+                struct iter
+                {
+                    int_type value;
+                    int_type operator *() const { return value; }
+                };
+
+                return iter{eat()};
+            }
+        };
+
+        using input_stream = std::conditional_t<is_contiguous_input, contiguous_input_stream, generic_input_stream>;
+
+        // decoded string output into string_input_buffer_
+        struct buffered_string_output
+        {
+            js_string& buffer_;
+            void operator +=(char_type c) { buffer_ += c; }
+            void append(const char_type* begin, const char_type* end) { buffer_.append(begin, end); }
+            [[nodiscard]] js_string_view view() const noexcept { return buffer_; }
+        };
+
+        // decoded string output into the source buffer (in-situ). it never overtakes the input position.
+        struct in_situ_string_output
+        {
+            char_type* const begin_;
+            char_type* end_;
+            bool& line_break_decoded_;
+            void operator +=(char_type c) { *end_++ = c, line_break_decoded_ |= c == '\n'; }
+            void append(const char_type* begin, const char_type* end) { end_ = std::copy(begin, end, end_); }
+            [[nodiscard]] js_string_view view() const noexcept { return js_string_view(begin_, static_cast<size_t>(end_ - begin_)); }
+        };
+
+        input_stream input_;
+        json_parse_option option_bits_{};
+        json::js_string string_input_buffer_{};
+        char_type* in_situ_begin_{};        // mutable alias of input begin, if parsing in-situ
+        bool in_situ_line_break_decoded_{}; // true if in-situ decoding wrote '\n' into the source text, then line numbers can't be rescanned.
+        const uint32_t* index_{};           // the next structural character, if reading in two stages
+        const uint32_t* index_end_{};
+        std::optional<size_t> offset_base_; // offset of the input in whole source text, if reading a part (then errors are reported with offset)
+        size_t max_depth_ = NANOJSON3_MAX_DEPTH;
+        size_t depth_{}; // used by recursive reading with structural index
+
+        // array or object being read
+        struct container_frame
+        {
+            bool object;
+            size_t count;
+        };
+
+        std::vector<container_frame> containers_{}; // explicit stack of the containers being read
+
+        // ctor
+        json_reader(CharInputIterator begin, CharInputIterator end, json_parse_option option) : input_(begin, end), option_bits_(option) { }
+
+        // executes parsing
+        template <class Handler>
+        void execute(Handler& handler)
+        {
+            string_input_buffer_.reserve(256);
+            containers_.reserve((std::min)(max_depth_, size_t{32}));
+            eat_utf8bom();
+            eat_whitespaces();
+            read_element(handler);
+        }
+
+        // gets the option bit enabled.
+        [[nodiscard]] bool has_option(json_parse_option bit) const noexcept
+        {
+            return (option_bits_ & bit) != json_parse_option::none;
+        }
+
+        // reads single node (with its children) from the stream.
+        // arrays and objects are read in a loop with explicit stack `containers_`, not recursively.
+        template <class Handler>
+        void read_element(Handler& handler)
+        {
+            const size_t bottom = containers_.size();
+            while (true)
+            {
+                // reads a value, or opens a container
+                if (*input_ == '[' || *input_ == '{')
+                {
+                    if (containers_.size() - bottom + depth_ >= max_depth_)
+                        throw bad_format("invalid json format: too deeply nested (max depth " + std::to_string(max_depth_) + ")", *input_);
+
+                    if (*input_ == '[')
+                    {
+                        ++input_;
+                        handler.on_start_array();
+                        eat_whitespaces();
+                        if (!input_.eat(']')) // not empty array
+                        {
+                            containers_.push_back(container_frame{false, 0});
+                            continue; // to the first element
+                        }
+                        handler.on_end_array(0);
+                    }
+                    else
+                    {
+                        ++input_;
+                        handler.on_start_object();
+                        eat_whitespaces();
+                        if (!input_.eat('}')) // not empty object
+                        {
+                            containers_.push_back(container_frame{true, 0});
+                            read_object_key(handler);
+                            continue; // to the first value
+                        }
+                        handler.on_end_object(0);
+                    }
+                }
+                else
+                {
+                    read_scalar(handler);
+                }
+
+                // reads `,` or closes containers after a value
+                while (true)
+                {
+                    if (containers_.size() == bottom) return;
+                    container_frame& f = containers_.back();
+                    ++f.count;
+
+                    eat_whitespaces();
+
+                    if (!f.object) // array
+                    {
+                        if (input_.eat(','))
+                        {
+                            eat_whitespaces();
+                            if (has_option(json_parse_option::allow_trailing_comma) && input_.eat(']')) { end_container(handler); continue; }
+                            else if (*input_ == ']') throw bad_format("invalid array format: expected an element (trailing comma not allowed)", *input_);
+                            break; // to the next element
+                        }
+                        else if (input_.eat(']')) { end_container(handler); continue; }
+                        else throw bad_format("invalid array format: ',' or ']' expected", *input_);
+                    }
+                    else // object
+                    {
+                        if (input_.eat(','))
+                        {
+                            eat_whitespaces();
+
+                            // check '}'
+                            if (input_.eat('}'))
+                            {
+                                if (has_option(json_parse_option::allow_trailing_comma)) { end_container(handler); continue; } // OK
+                                else throw bad_format("invalid object format: expected an element (trailing comma not allowed)", *input_);
+                            }
+
+                            read_object_key(handler);
+                            break; // to the next value
+                        }
+                        else if (input_.eat('}')) { end_container(handler); continue; }
+                        else throw bad_format("invalid object format: expected ',' or '}'", *input_);
+                    }
+                }
+            }
+        }
+
+        // reads `key :` of object member
+        template <class Handler>
+        void read_object_key(Handler& handler)
+        {
+            const size_t offset = source_offset();
+            if (*input_ == '"') notify_key(handler, read_string(), offset); // quoted key (normal)
+            else if (has_option(json_parse_option::allow_unquoted_object_key)) notify_key(handler, read_unquoted_key(), offset);
+            else throw bad_format("invalid object format: expected object key", *input_);
+
+            eat_whitespaces();
+
+            if (!input_.eat(':'))
+                throw bad_format("invalid object format: expected a ':'", *input_);
+
+            eat_whitespaces();
+        }
+
+        // closes the innermost container
+        template <class Handler>
+        void end_container(Handler& handler)
+        {
+            const container_frame f = containers_.back();
+            containers_.pop_back();
+            if (f.object) handler.on_end_object(f.count);
+            else handler.on_end_array(f.count);
+        }
+
+        // reads literal, number or string from the stream.
+        template <class Handler>
+        void read_scalar(Handler& handler)
+        {
+            switch (*input_)
+            {
+            case 'n': // `null`
+                if (!input_.eat('n')) throw bad_format("invalid 'null' literal: expected 'n'", *input_);
+                if (!input_.eat('u')) throw bad_format("invalid 'null' literal: expected 'u'", *input_);
+                if (!input_.eat('l')) throw bad_format("invalid 'null' literal: expected 'l'", *input_);
+                if (!input_.eat('l')) throw bad_format("invalid 'null' literal: expected 'l'", *input_);
+                return handler.on_null();
+
+            case 't': // `true`
+                if (!input_.eat('t')) throw bad_format("invalid 'true' literal: expected 't'", *input_);
+                if (!input_.eat('r')) throw bad_format("invalid 'true' literal: expected 'r'", *input_);
+                if (!input_.eat('u')) throw bad_format("invalid 'true' literal: expected 'u'", *input_);
+                if (!input_.eat('e')) throw bad_format("invalid 'true' literal: expected 'e'", *input_);
+                return handler.on_boolean(true);
+
+            case 'f': // `false`
+                if (!input_.eat('f')) throw bad_format("invalid 'false' literal: expected 'f'", *input_);
+                if (!input_.eat('a')) throw bad_format("invalid 'false' literal: expected 'a'", *input_);
+                if (!input_.eat('l')) throw bad_format("invalid 'false' literal: expected 'l'", *input_);
+                if (!input_.eat('s')) throw bad_format("invalid 'false' literal: expected 's'", *input_);
+                if (!input_.eat('e')) throw bad_format("invalid 'false' literal: expected 'e'", *input_);
+                return handler.on_boolean(false);
+
+            case '+':
+            case '-':
+            case '0':
+            case '1':
+            case '2':
+            case '3':
+            case '4':
+            case '5':
+            case '6':
+            case '7':
+            case '8':
+            case '9':
+                return read_number(handler);
+
+            case '"':
+                return handler.on_string(read_string());
+
+            default:
+                break;
+            }
+
+            throw bad_format("invalid json format: expected an element", *input_);
+        }
+
+        // true if `Handler` receives the offset of keys (`on_key(js_string_view, size_t)`)
+        template <class Handler, class = void> struct accepts_key_offset : std::false_type { };
+        template <class Handler> struct accepts_key_offset<Handler, std::void_t<decltype(std::declval<Handler&>().on_key(std::declval<js_string_view>(), size_t{}))>> : std::true_type { };
+
+        // notifies object key at `offset` in the source text
+        template <class Handler>
+        static void notify_key(Handler& handler, js_string_view key, size_t offset)
+        {
+            if constexpr (accepts_key_offset<Handler>::value) handler.on_key(key, offset);
+            else handler.on_key(key);
+        }
+
+        // gets current offset in the whole source text
+        [[nodiscard]] size_t source_offset() const
+        {
+            return offset_base_.value_or(0) + input_.offset();
+        }
+
+        // true if `Handler` receives number text (`on_raw_number`)
+        template <class Handler, class = void> struct accepts_raw_number : std::false_type { };
+        template <class Handler> struct accepts_raw_number<Handler, std::void_t<decltype(std::declval<Handler&>().on_raw_number(std::declval<js_string_view>()))>> : std::true_type { };
+
+        // reads integer or floating
+        template <class Handler>
+        void read_number(Handler& handler)
+        {
+            if constexpr (accepts_raw_number<Handler>::value)
+                if (has_option(json_parse_option::raw_number)) return read_raw_number(handler);
+
+            constexpr auto is_digit = [](int_type i)-> bool { return i >= '0' && i <= '9'; }; // locale-independent is_digit
+
+            char buffer[128]{};
+            char* p = buffer;
+            char* const integer_limit = buffer + 60;
+            char* const fraction_limit = buffer + 64;
+            char* const decimal_limit = buffer + 128;
+
+            int exp_offset = 0;
+            constexpr auto maximum_exp_offset = (std::numeric_limits<decltype(exp_offset)>::max)();
+            constexpr auto minimum_exp_offset = (std::numeric_limits<decltype(exp_offset)>::lowest)();
+
+            bool integer_type = true;
+
+            // parse integer part
+            {
+                if (input_.eat('-')) { *p++ = '-'; }                                                  // minus sign
+                if (has_option(json_parse_option::allow_number_with_plus_sign) && input_.eat('+')) {} // ignore plus sign
+
+                if (input_.eat('0')) { *p++ = '0'; } // put '0', leading zeros are not allowed in JSON.
+                else if (is_digit(*input_))          // not zero
+                {
+                    while (is_digit(*input_))
+                        if (p < integer_limit) *p++ = static_cast<char_type>(*input_++);  // put digit
+                        else if (exp_offset < maximum_exp_offset) ++exp_offset, ++input_; // drop digit
+                        else throw bad_format("invalid number format: too long integer sequence");
+                }
+                else throw bad_format("invalid number format: expected a digit", *input_);
+            }
+
+            if (input_.eat('.')) // accept fraction point part
+            {
+                assert(p < fraction_limit);
+                *p++ = '.'; // put decimal point
+                integer_type = false;
+
+                if (is_digit(*input_))
+                {
+                    // if integer part is zero (parse '-0.0000...ddd')
+                    if ((buffer[0] == '0') || (buffer[0] == '-' && buffer[1] == '0'))
+                    {
+                        while (*input_ == '0')
+                            if (exp_offset > minimum_exp_offset) --exp_offset, ++input_; // drop '0'
+                            else throw bad_format("invalid number format: too long integer sequence");
+                    }
+
+                    while (is_digit(*input_))
+                    {
+                        if (p < fraction_limit) *p++ = static_cast<char_type>(*input_++); // put digit
+                        else ++input_;                                                    // drop digit
+                    }
+                }
+                else throw bad_format("invalid number format: expected a digit", *input_);
+            }
+
+            if (*input_ == 'e' || *input_ == 'E') // accept exponent part
+            {
+                ++input_; // 'e'
+                integer_type = false;
+
+                char exp_part[32]{};
+                char* exp = exp_part;
+                char* const exp_limit = exp_part + std::size(exp_part);
+
+                // read
+
+                if (input_.eat('-')) { *exp++ = '-'; }
+                else if (input_.eat('+')) {} // drop '+'
+
+                if (is_digit(*input_))
+                {
+                    while (is_digit(*input_))
+                    {
+                        if (exp < exp_limit) *exp++ = static_cast<char_type>(*input_++); // put digit
+                        else ++input_;                                                   // drop digit (it must be overflow, handle later)
+                    }
+                }
+                else throw bad_format("invalid number format: expected a digit", *input_);
+
+                // parse exponent
+                int exp_value{};
+                auto [ptr, ec] = std::from_chars(exp_part, exp, exp_value, 10);
+
+                if (ec == std::errc{} && ptr == exp)
+                {
+                    exp_offset = exp_offset > 0 && exp_value > maximum_exp_offset - exp_offset ? maximum_exp_offset : exp_offset < 0 && exp_value < minimum_exp_offset - exp_offset ? minimum_exp_offset : exp_offset + exp_value;
+                }
+                else if (ec == std::errc::result_out_of_range && ptr == exp)
+                {
+                    exp_offset = exp_part[0] == '-' ? maximum_exp_offset : minimum_exp_offset;
+                }
+                else // other error (bug)
+                {
+                    assert(false);
+                    throw bad_format("invalid number format: unexpected parse error "); // unexpected
+                }
+            }
+
+            if (exp_offset != 0) // append parsed exponent part to buffer
+            {
+                integer_type = false;
+                assert(p < decimal_limit);
+                if (p < decimal_limit) *p++ = 'e';
+                auto [ptr, ec] = std::to_chars(p, decimal_limit, exp_offset, 10);
+                if (ec != std::errc{}) throw bad_format("invalid number format: unexpected error.");
+                p = ptr;
+            }
+
+            // try to parse as integer type
+            if (integer_type)
+            {
+                json::js_integer ret{};
+                auto [ptr, ec] = std::from_chars(buffer, p, ret, 10);
+                if (ec == std::errc{} && ptr == p) return handler.on_integer(ret); // integer OK
+            }
+
+            // try to parse as floating type (should succeed)
+            {
+                json::js_floating ret{};
+#if (defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L) // compiler has floating-point from_chars
+                auto [ptr, ec] = std::from_chars(buffer, p, ret);
+#else // use fallback implementation
+                std::istringstream tmp{std::string(buffer, p)};
+                tmp.imbue(std::locale::classic());
+                tmp >> ret;
+                std::errc ec = !tmp ? std::errc::result_out_of_range : std::errc{}; // if fails, assume it must be out of range.
+                const char* ptr = !tmp ? p : tmp.eof() ? p : buffer + tmp.tellg();
+#endif
+
+                assert(ec == std::errc{} || ec == std::errc::result_out_of_range);
+                assert(ptr == p);
+
+                if (ptr == p && ec == std::errc{}) return handler.on_floating(ret); // floating OK
+
+                if (ec == std::errc::result_out_of_range) // overflow or underflow
+                {
+                    if (exp_offset >= 0) // overflow
+                        return handler.on_floating(buffer[0] != '-' ? +std::numeric_limits<json::js_floating>::infinity() : -std::numeric_limits<json::js_floating>::infinity());
+                    else // underflow
+                        return handler.on_floating(buffer[0] != '-' ? +static_cast<json::js_floating>(+0.0) : -static_cast<json::js_floating>(-0.0));
+                }
+            }
+
+            assert(false);
+            throw bad_format("invalid number format: failed to parse");
+        }
+
+        // reads number without conversion, and notifies its text (without the plus sign `allow_number_with_plus_sign` accepts) to `handler`.
+        // the text refers to the source if the input is contiguous, or string_input_buffer_.
+        template <class Handler>
+        void read_raw_number(Handler& handler)
+        {
+            constexpr auto is_digit = [](int_type i)-> bool { return i >= '0' && i <= '9'; }; // locale-independent is_digit
+
+            [[maybe_unused]] const char_type* begin = nullptr;
+            if constexpr (is_contiguous_input) begin = input_.it_;
+            js_string& text = string_input_buffer_;
+            text.clear();
+            bool plus_sign = false;
+
+            auto put = [&] // eats current character into the text
+            {
+                const int_type c = input_.eat();
+                if constexpr (!is_contiguous_input) text += char_traits::to_char_type(c);
+            };
+
+            auto digits = [&] // eats one or more digits
+            {
+                if (!is_digit(*input_)) throw bad_format("invalid number format: expected a digit", *input_);
+                while (is_digit(*input_)) put();
+            };
+
+            if (*input_ == '-') put();
+            if (has_option(json_parse_option::allow_number_with_plus_sign) && *input_ == '+') plus_sign = true, put();
+
+            if (*input_ == '0') put(); // leading zeros are not allowed in JSON.
+            else digits();
+
+            if (*input_ == '.') put(), digits();
+            if (*input_ == 'e' || *input_ == 'E')
+            {
+                put();
+                if (*input_ == '-' || *input_ == '+') put();
+                digits();
+            }
+
+            if constexpr (is_contiguous_input)
+            {
+                if (!plus_sign) return handler.on_raw_number(js_string_view(begin, static_cast<size_t>(input_.it_ - begin)));
+                text.assign(begin, input_.it_);
+            }
+
+            if (plus_sign) text.erase(text[0] == '-' ? 1 : 0, 1);
+            return handler.on_raw_number(js_string_view(text));
+        }
+
+        // reads quoted string, returns decoded string.
+        // the result refers to the source (or string_input_buffer_), valid until the next read.
+        js_string_view read_string()
+        {
+            // check quote character
+            assert(*input_ == '"');
+            int_type quote = *input_++; // '"'
+
+            if constexpr (is_contiguous_input)
+            {
+                // fast path: no escape sequence in the string, returns the source range directly.
+                const char_type* begin = input_.it_;
+                const char_type* end = find_string_special(begin);
+                input_.it_ = end;
+                if (input_.eat(quote)) return js_string_view(begin, static_cast<size_t>(end - begin));
+
+                if (in_situ_begin_) // decodes the rest in place, following the run already in place.
+                {
+                    char_type* const in_situ_end = in_situ_begin_ + (end - input_.begin_);
+                    return read_string_remainder(quote, in_situ_string_output{in_situ_end - (end - begin), in_situ_end, in_situ_line_break_decoded_});
+                }
+
+                string_input_buffer_.assign(begin, end);
+                return read_string_remainder(quote, buffered_string_output{string_input_buffer_});
+            }
+            else
+            {
+                string_input_buffer_.clear();
+                return read_string_remainder(quote, buffered_string_output{string_input_buffer_});
+            }
+        }
+
+        // reads the rest of quoted string into `ret`
+        template <class StringOutput>
+        js_string_view read_string_remainder(int_type quote, StringOutput&& ret)
+        {
+            while (true)
+            {
+                if (input_.eat('\\')) // escape sequence found?
+                {
+                    if (*input_ == 'n') ret += '\n';
+                    else if (*input_ == 't') ret += '\t';
+                    else if (*input_ == 'b') ret += '\b';
+                    else if (*input_ == 'f') ret += '\f';
+                    else if (*input_ == 'r') ret += '\r';
+                    else if (*input_ == '\\') ret += '\\';
+                    else if (*input_ == '/') ret += '/';
+                    else if (*input_ == '\"') ret += '\"';
+                    else if (*input_ == '\'') ret += '\'';
+                    else if (*input_ == 'u') // \uXXXX is converted to UTF-8 sequence
+                    {
+                        auto hex = [&](int_type chr)
+                        {
+                            if (chr >= '0' && chr <= '9') { return chr - '0'; }
+                            if (chr >= 'A' && chr <= 'F') { return chr - 'A' + 10; }
+                            if (chr >= 'a' && chr <= 'f') { return chr - 'a' + 10; }
+                            throw bad_format("invalid string format: expected hexadecimal digit for \\u????", chr);
+                        };
+
+                        int code = 0;
+                        code = code << 4 | hex(*++input_);
+                        code = code << 4 | hex(*++input_);
+                        code = code << 4 | hex(*++input_);
+                        code = code << 4 | hex(*++input_);
+
+                        if (code < 0x80) // 7 bit
+                        {
+                            ret += static_cast<char>((code >> 0 & 0x7F) | 0x00);
+                        }
+                        else if (code < 0x0800) // 11 bit
+                        {
+                            ret += static_cast<char>((code >> 6 & 0x1f) | 0xC0);
+                            ret += static_cast<char>((code >> 0 & 0x3f) | 0x80);
+                        }
+                        else if ((code & 0xF800) == 0xD800) // surrogate pair
+                        {
+                            // assume next surrogate is following.
+                            if (*++input_ != '\\') throw bad_format("invalid string format: expected surrogate pair", *input_);
+                            if (*++input_ != 'u') throw bad_format("invalid string format: expected surrogate pair", *input_);
+
+                            int code2 = 0;
+                            code2 = code2 << 4 | hex(*++input_);
+                            code2 = code2 << 4 | hex(*++input_);
+                            code2 = code2 << 4 | hex(*++input_);
+                            code2 = code2 << 4 | hex(*++input_);
+
+                            if ((code & 0xFC00) == 0xDC00 && (code2 & 0xFC00) == 0xD800)
+                                std::swap(code, code2);
+
+                            if ((code & 0xFC00) == 0xD800 && (code2 & 0xFC00) == 0xDC00)
+                                code = ((code & 0x3FF) << 10 | (code2 & 0x3FF)) + 0x10000; // 21 bit
+                            else
+                                throw bad_format("invalid string format: invalid surrogate pair sequence");
+
+                            ret += static_cast<char>((code >> 18 & 0x07) | 0xF0);
+                            ret += static_cast<char>((code >> 12 & 0x3f) | 0x80);
+                            ret += static_cast<char>((code >> 6 & 0x3f) | 0x80);
+                            ret += static_cast<char>((code >> 0 & 0x3f) | 0x80);
+                        }
+                        else // 16 bit
+                        {
+                            ret += static_cast<char>((code >> 12 & 0x0f) | 0xE0);
+                            ret += static_cast<char>((code >> 6 & 0x3f) | 0x80);
+                            ret += static_cast<char>((code >> 0 & 0x3f) | 0x80);
+                        }
+                    }
+                    else
+                    {
+                        throw bad_format("invalid string format: invalid escape sequence");
+                    }
+                }
+                else if (input_.eat(quote)) break; // end of string.
+                else if (*input_ == EOF) throw bad_format("invalid string format: unexpected eof");
+                else if (*input_ < 0x20 || *input_ == 0x7F) throw bad_format("invalid string format: control character is not allowed", *input_);
+                else if (*input_ == '/' && !has_option(json_parse_option::allow_unescaped_forward_slash)) throw bad_format("invalid string format: unescaped '/' is not allowed");
+                else if (*input_ >= 0x80 && has_option(json_parse_option::validate_utf8))
+                {
+                    read_utf8_sequence(ret);
+                    continue;
+                }
+                else ret += static_cast<char_type>(*input_); // OK. normal character.
+                ++input_;
+
+                if constexpr (is_contiguous_input)
+                {
+                    // appends following normal characters at once
+                    const char_type* begin = input_.it_;
+                    const char_type* end = find_string_special(begin);
+                    ret.append(begin, end);
+                    input_.it_ = end;
+                }
+            }
+
+            return ret.view();
+        }
+
+        // reads a UTF-8 sequence of a non-ASCII character into `ret`, validating it.
+        template <class StringOutput>
+        void read_utf8_sequence(StringOutput&& ret)
+        {
+            const int_type lead = *input_;
+            const auto [length, second_min, second_max] = internal::scan::utf8_rule(static_cast<unsigned char>(lead));
+            if (length == 0) throw bad_format("invalid string format: invalid UTF-8 sequence", lead);
+
+            ret += static_cast<char_type>(*input_++);
+            for (int i = 1; i < length; i++)
+            {
+                const int_type c = *input_;
+                if (i == 1 ? c < second_min || c > second_max : (c & 0xC0) != 0x80) throw bad_format("invalid string format: invalid UTF-8 sequence", c);
+                ret += static_cast<char_type>(*input_++);
+            }
+        }
+
+        // finds a character which needs special treatment in a string literal from `p` (see `internal::scan::find_string_special`).
+        // with `validate_utf8`, skips valid UTF-8 sequences (and stops at invalid one).
+        template <bool contiguous = is_contiguous_input, std::enable_if_t<contiguous>* = nullptr>
+        [[nodiscard]] const char_type* find_string_special(const char_type* p) const noexcept
+        {
+            const bool escaped_slash = !has_option(json_parse_option::allow_unescaped_forward_slash);
+            if (!has_option(json_parse_option::validate_utf8)) return internal::scan::find_string_special(p, input_.end_, escaped_slash);
+
+            while (true)
+            {
+                p = internal::scan::find_string_special(p, input_.end_, escaped_slash, true);
+                const char_type* next = internal::scan::skip_utf8_sequences(p, input_.end_);
+                if (next == p) return p; // not a valid non-ASCII character
+                p = next;
+            }
+        }
+
+        // moves to the next structural character (or the end)
+        void next_structural() noexcept
+        {
+            input_.it_ = index_ != index_end_ ? input_.begin_ + *index_++ : input_.end_;
+        }
+
+        // reads single node at the structural character
+        template <class Handler>
+        void read_element_indexed(Handler& handler)
+        {
+            if (*input_ == '[' || *input_ == '{')
+            {
+                if (depth_ >= max_depth_)
+                    throw bad_format("invalid json format: too deeply nested (max depth " + std::to_string(max_depth_) + ")", *input_);
+
+                ++depth_;
+                if (*input_ == '[') read_array_indexed(handler);
+                else read_object_indexed(handler);
+                --depth_;
+                return;
+            }
+
+            read_scalar(handler); // literal, number or string
+
+            // the token must be followed by a white space or the next structural character.
+            const char_type* next = index_ != index_end_ ? input_.begin_ + *index_ : input_.end_;
+            if (input_.it_ != next && !(input_.it_ < next && internal::scan::is_space(*input_.it_)))
+                throw bad_format("invalid json format: unexpected character", *input_);
+        }
+
+        // reads array `[...]` at the structural character
+        template <class Handler>
+        void read_array_indexed(Handler& handler)
+        {
+            handler.on_start_array();
+
+            next_structural();
+            if (*input_ == ']') return handler.on_end_array(0); // empty array
+
+            size_t count = 0;
+            while (true)
+            {
+                read_element_indexed(handler);
+                ++count;
+
+                next_structural();
+                if (*input_ == ',')
+                {
+                    next_structural();
+                    if (*input_ != ']') continue;
+                    if (has_option(json_parse_option::allow_trailing_comma)) break;
+                    throw bad_format("invalid array format: expected an element (trailing comma not allowed)", *input_);
+                }
+                if (*input_ == ']') break;
+                throw bad_format("invalid array format: ',' or ']' expected", *input_);
+            }
+
+            handler.on_end_array(count);
+        }
+
+        // reads object `{...}` at the structural character
+        template <class Handler>
+        void read_object_indexed(Handler& handler)
+        {
+            handler.on_start_object();
+
+            next_structural();
+            if (*input_ == '}') return handler.on_end_object(0); // empty object
+
+            size_t count = 0;
+            while (true)
+            {
+                if (*input_ != '"') throw bad_format("invalid object format: expected object key", *input_);
+                const size_t offset = source_offset();
+                notify_key(handler, read_string(), offset);
+
+                next_structural();
+                if (*input_ != ':') throw bad_format("invalid object format: expected a ':'", *input_);
+
+                next_structural();
+                read_element_indexed(handler);
+                ++count;
+
+                next_structural();
+                if (*input_ == ',')
+                {
+                    next_structural();
+                    if (*input_ != '}') continue;
+                    if (has_option(json_parse_option::allow_trailing_comma)) break;
+                    throw bad_format("invalid object format: expected an element (trailing comma not allowed)", *input_);
+                }
+                if (*input_ == '}') break;
+                throw bad_format("invalid object format: expected ',' or '}'", *input_);
+            }
+
+            handler.on_end_object(count);
+        }
+
+        // reads non-quoted object key, returns it (valid until the next read)
+        js_string_view read_unquoted_key()
+        {
+            constexpr auto is_key_char = [](int_type i)-> bool { return i != EOF && i > ' ' && i != ':'; }; // until delimiter found
+
+            if constexpr (is_contiguous_input)
+            {
+                const char_type* begin = input_.it_;
+                while (is_key_char(*input_)) ++input_;
+                return js_string_view(begin, static_cast<size_t>(input_.it_ - begin));
+            }
+            else
+            {
+                string_input_buffer_.clear();
+                while (is_key_char(*input_))
+                    string_input_buffer_ += static_cast<char_type>(*input_++); // read a character as object key
+                return string_input_buffer_;
+            }
+        }
+
+        // eats BOM sequence `EFBBBF` if allowed.
+        void eat_utf8bom()
+        {
+            if (input_.eat(0xEF)) // if stream starts with 0xEF, regard it as beginning of UTF-8 BOM.
+            {
+                if (!has_option(json_parse_option::allow_utf8_bom)) throw bad_format("invalid json format: expected an element. (UTF-8 BOM not allowed)", *input_);
+                if (!input_.eat(0xBB)) throw bad_format("invalid json format: UTF-8 BOM sequence expected... 0xBB", *input_);
+                if (!input_.eat(0xBF)) throw bad_format("invalid json format: UTF-8 BOM sequence expected... 0xBF", *input_);
+            }
+        }
+
+        // eats continuous white spaces and comments `/*...*/`, `//...\n`
+        void eat_whitespaces()
+        {
+            if constexpr (is_contiguous_input)
+            {
+                while (true)
+                {
+                    input_.it_ = internal::scan::skip_whitespaces(input_.it_, input_.end_);
+
+                    if (has_option(json_parse_option::allow_comment) && input_.eat('/'))
+                    {
+                        if (input_.eat('*')) input_.it_ = internal::scan::skip_block_comment(input_.it_, input_.end_);     // start of block comment
+                        else if (input_.eat('/')) input_.it_ = internal::scan::skip_line_comment(input_.it_, input_.end_); // start of line comment
+                        continue;
+                    }
+
+                    break;
+                }
+            }
+            else
+            {
+                // locale-independent is_space
+                constexpr auto is_space = [](int_type i)-> bool { return i == ' ' || i == '\t' || i == '\r' || i == '\n'; };
+
+                while (true)
+                {
+                    while (is_space(*input_)) ++input_;
+
+                    if (has_option(json_parse_option::allow_comment) && input_.eat('/'))
+                    {
+                        if (input_.eat('*')) // start of block comment
+                        {
+                            while (*input_ != EOF)
+                            {
+                                if (*input_++ == '*' && input_.eat('/'))
+                                    break;
+                            }
+                        }
+                        else if (input_.eat('/')) // start of line comment
+                        {
+                            while (*input_ != EOF)
+                            {
+                                if (*input_++ == '\n')
+                                    break;
+                            }
+                        }
+
+                        continue;
+                    }
+
+                    break;
+                }
+            }
+        }
+
+        // makes a bad_format exception with error message
+        [[nodiscard]] exceptions::bad_format bad_format(std::string_view reason, std::optional<int_type> but_encountered = std::nullopt) const
+        {
+            if (offset_base_) return make_bad_format(reason, but_encountered, std::nullopt, *offset_base_ + input_.offset());
+            return make_bad_format(reason, but_encountered, !in_situ_line_break_decoded_ ? input_.position() : std::nullopt, input_.offset());
+        }
+
+        // makes a bad_format exception with error message, at `position` or `offset` if the position is unknown.
+        [[nodiscard]] static exceptions::bad_format make_bad_format(std::string_view reason, std::optional<int_type> but_encountered, std::optional<source_position> position, size_t offset)
+        {
+            std::stringstream message;
+            message << "bad_format: ";
+            message << reason;
+            if (but_encountered)
+            {
+                message << " but encountered ";
+                if (*but_encountered == EOF)
+                {
+                    message << "EOF";
+                }
+                else if (*but_encountered >= 0x20 && but_encountered < 0x7F)
+                {
+                    message << "'";
+                    message << static_cast<char>(*but_encountered);
+                    message << "'";
+                }
+                else
+                {
+                    message << "(char)";
+                    message << std::hex << std::setfill('0') << std::setw(2) << *but_encountered << std::dec;
+                }
+            }
+            if (position)
+            {
+                message << " at line ";
+                message << (position->line + 1);
+                message << " column ";
+                message << (position->column + 1);
+            }
+            else
+            {
+                message << " at offset ";
+                message << offset;
+            }
+            message << ".";
+
+            return exceptions::bad_format{message.str()};
+        }
+    };
+
+    // tokens of json_cursor
+    enum struct json_token : unsigned char
+    {
+        end, // no more tokens (after the root element)
+        null,
+        boolean,
+        integer,
+        floating,
+        string,
+        key, // object member key
+        start_array,
+        end_array,
+        start_object,
+        end_object,
+    };
+
+    /// json_parser: reusable parser keeping its buffers between documents
+    /// (the reader's string buffer and container stack, the builder's stacks, and emptied arrays/objects to reuse).
+    /// Not thread-safe: use one parser per thread.
+    /// usage:
+    ///     njs3::json_parser parser{};
+    ///     njs3::json json{};
+    ///     for (auto&& message : messages) parser.parse_into(message, json);
+    class json_parser
+    {
+        using reader_type = json::json_reader<const json::char_type*>;
+
+        json_parse_option option_bits_{};
+        size_t max_depth_{};
+        json::js_string string_buffer_{};
+        std::vector<reader_type::container_frame> containers_{};
+        json_document_builder<json> builder_{};
+
+    public:
+        explicit json_parser(json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH) : option_bits_(loose), max_depth_(max_depth), builder_(loose) { }
+
+        // parses `sv` into new json.
+        [[nodiscard]] json parse(json::json_string_view sv)
+        {
+            read(sv);
+            return builder_.result();
+        }
+
+        // parses `sv` into `target`, reusing the capacity of arrays and objects `target` had.
+        // on error, throws bad_format and `target` is left undefined.
+        void parse_into(json::json_string_view sv, json& target)
+        {
+            builder_.recycle(std::move(target));
+            target = json{};
+            read(sv);
+            target = builder_.result();
+        }
+
+    private:
+        void read(json::json_string_view sv)
+        {
+            reader_type reader(sv.data(), sv.data() + sv.size(), option_bits_);
+            reader.max_depth_ = max_depth_;
+            lend_buffers(reader);
+            try
+            {
+                reader.execute(builder_);
+            }
+            catch (...)
+            {
+                lend_buffers(reader); // takes back
+                builder_.reset();
+                throw;
+            }
+            lend_buffers(reader); // takes back
+        }
+
+        // swaps the scratch buffers with `reader`
+        void lend_buffers(reader_type& reader) noexcept
+        {
+            std::swap(string_buffer_, reader.string_input_buffer_);
+            std::swap(containers_, reader.containers_);
+            containers_.clear();
+        }
+    };
+
+    /// json_cursor: pull-style reader, reads one token at a time with the tokenizer of json_reader.
+    /// usage:
+    ///     njs3::json_cursor cursor(R"({"id": 1, "tags": ["a", "b"]})");
+    ///     cursor.next_token(); // start_object
+    ///     while (cursor.next_token() == njs3::json_token::key)
+    ///         if (cursor.get_string() == "id") id = cursor.read_integer();
+    ///         else cursor.skip_value();
+    template <class CharInputIterator = const json::char_type*>
+    class json_cursor
+    {
+        using reader_type = json::json_reader<CharInputIterator>;
+        friend class json_lazy_view;
+
+        // receives the scalar read by json_reader::read_scalar
+        struct scalar_handler : json_event_handler
+        {
+            json_cursor& cursor_;
+            void on_null() { cursor_.token_ = json_token::null; }
+            void on_boolean(json::js_boolean value) { cursor_.token_ = json_token::boolean, cursor_.boolean_ = value; }
+            void on_integer(json::js_integer value) { cursor_.token_ = json_token::integer, cursor_.integer_ = value; }
+            void on_floating(json::js_floating value) { cursor_.token_ = json_token::floating, cursor_.floating_ = value; }
+            void on_string(json::js_string_view value) { cursor_.token_ = json_token::string, cursor_.string_ = value; }
+        };
+
+        // array or object being read
+        struct frame
+        {
+            bool object{};
+            bool after_key{}; // object: the next is the value
+            size_t count{};   // number of elements (or keys) read
+        };
+
+        reader_type reader_;
+        std::vector<frame> frames_{};
+        bool started_{};
+        json_token token_ = json_token::end;
+        json::js_boolean boolean_{};
+        json::js_integer integer_{};
+        json::js_floating floating_{};
+        json::js_string_view string_{}; // string or key, valid until the next token
+        size_t key_offset_{};           // offset of the last key in the source text
+
+    public:
+        // arrays and objects nested deeper than `max_depth` are rejected with bad_format.
+        json_cursor(CharInputIterator begin, CharInputIterator end, json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH)
+            : reader_(std::move(begin), std::move(end), loose)
+        {
+            reader_.max_depth_ = max_depth;
+        }
+
+        template <class It = CharInputIterator, std::enable_if_t<std::is_same_v<It, const json::char_type*>>* = nullptr>
+        json_cursor(json::json_string_view sv, json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH)
+            : json_cursor(sv.data(), sv.data() + sv.size(), loose, max_depth) { }
+
+        json_cursor(const json_cursor& other) = delete;
+        json_cursor(json_cursor&& other) noexcept = default;
+        json_cursor& operator=(const json_cursor& other) = delete;
+        ~json_cursor() = default;
+
+    public: // reading tokens
+        // reads the next token, returns its kind
+        json_token next_token()
+        {
+            if (frames_.empty()) // root
+            {
+                if (started_) return token_ = json_token::end; // ignores the rest, as json_reader does.
+                started_ = true;
+                reader_.eat_utf8bom();
+                reader_.eat_whitespaces();
+                return read_value();
+            }
+
+            auto& input = reader_.input_;
+            frame& f = frames_.back();
+            reader_.eat_whitespaces();
+
+            if (f.object)
+            {
+                if (f.after_key)
+                {
+                    if (!input.eat(':')) throw reader_.bad_format("invalid object format: expected a ':'", *input);
+                    reader_.eat_whitespaces();
+                    f.after_key = false;
+                    return read_value();
+                }
+
+                if (f.count != 0)
+                {
+                    if (input.eat(','))
+                    {
+                        reader_.eat_whitespaces();
+                        if (input.eat('}'))
+                        {
+                            if (reader_.has_option(json_parse_option::allow_trailing_comma)) return end_container(json_token::end_object);
+                            throw reader_.bad_format("invalid object format: expected an element (trailing comma not allowed)", *input);
+                        }
+                    }
+                    else if (input.eat('}')) return end_container(json_token::end_object);
+                    else throw reader_.bad_format("invalid object format: expected ',' or '}'", *input);
+                }
+                else if (input.eat('}')) return end_container(json_token::end_object); // empty object
+
+                key_offset_ = reader_.source_offset();
+                if (*input == '"') string_ = reader_.read_string(); // quoted key (normal)
+                else if (reader_.has_option(json_parse_option::allow_unquoted_object_key)) string_ = reader_.read_unquoted_key();
+                else throw reader_.bad_format("invalid object format: expected object key", *input);
+
+                f.after_key = true;
+                f.count++;
+                return token_ = json_token::key;
+            }
+            else
+            {
+                if (f.count != 0)
+                {
+                    if (input.eat(','))
+                    {
+                        reader_.eat_whitespaces();
+                        if (reader_.has_option(json_parse_option::allow_trailing_comma) && input.eat(']')) return end_container(json_token::end_array);
+                        else if (*input == ']') throw reader_.bad_format("invalid array format: expected an element (trailing comma not allowed)", *input);
+                    }
+                    else if (input.eat(']')) return end_container(json_token::end_array);
+                    else throw reader_.bad_format("invalid array format: ',' or ']' expected", *input);
+                }
+                else if (input.eat(']')) return end_container(json_token::end_array); // empty array
+
+                f.count++;
+                return read_value();
+            }
+        }
+
+        // skips the rest of the current array or object, if the current token is start_array or start_object.
+        // then the current token is the corresponding end_array or end_object.
+        void skip_children()
+        {
+            if (token_ != json_token::start_array && token_ != json_token::start_object) return;
+            for (const size_t depth = frames_.size(); frames_.size() >= depth;)
+                (void)next_token();
+        }
+
+        // skips the next value (whole array or object, if starts)
+        void skip_value()
+        {
+            (void)next_token();
+            skip_children();
+        }
+
+        // skips like `skip_children`, but only finds the closing bracket with quote-aware scan, without reading tokens.
+        // the skipped text is not validated. (falls back to `skip_children` for non-contiguous input, or if `allow_comment` is enabled.)
+        void skip_children_unchecked()
+        {
+            if (token_ != json_token::start_array && token_ != json_token::start_object) return;
+            if constexpr (reader_type::is_contiguous_input)
+            {
+                if (!reader_.has_option(json_parse_option::allow_comment))
+                {
+                    auto& input = reader_.input_;
+                    const auto closing = internal::scan::find_closing_bracket(input.it_, input.end_);
+                    if (!closing)
+                    {
+                        input.it_ = input.end_;
+                        throw reader_.bad_format("invalid json format: array or object is not closed", *input);
+                    }
+                    input.it_ = closing + 1;
+                    return (void)end_container(frames_.back().object ? json_token::end_object : json_token::end_array);
+                }
+            }
+            skip_children();
+        }
+
+        // skips the next value like `skip_value`, but skips the children of array or object by `skip_children_unchecked`.
+        void skip_value_unchecked()
+        {
+            (void)next_token();
+            skip_children_unchecked();
+        }
+
+        // reads the next value (whole array or object, if starts) as json.
+        // returns undefined if no value follows (the current array or object ends).
+        [[nodiscard]] json read_json() { return (void)next_token(), get_json(); }
+
+        // gets the current value (whole array or object, if the current token starts it) as json.
+        // returns undefined at the end of array or object. throws bad_access at a key.
+        [[nodiscard]] json get_json()
+        {
+            if (token_ == json_token::end || token_ == json_token::end_array || token_ == json_token::end_object) return json{};
+            if (token_ == json_token::key) throw bad_access(); // not at a value
+
+            json_document_builder<json> builder(reader_.option_bits_);
+            const size_t depth = frames_.size() - (token_ == json_token::start_array || token_ == json_token::start_object ? 1 : 0);
+            for (json_token token = token_;; token = next_token())
+            {
+                switch (token)
+                {
+                case json_token::end: return json{};
+                case json_token::null: builder.on_null();
+                    break;
+                case json_token::boolean: builder.on_boolean(boolean_);
+                    break;
+                case json_token::integer: builder.on_integer(integer_);
+                    break;
+                case json_token::floating: builder.on_floating(floating_);
+                    break;
+                case json_token::string: builder.on_string(string_);
+                    break;
+                case json_token::key: builder.on_key(string_, key_offset_);
+                    break;
+                case json_token::start_array: builder.on_start_array();
+                    break;
+                case json_token::end_array: builder.on_end_array(0);
+                    break;
+                case json_token::start_object: builder.on_start_object();
+                    break;
+                case json_token::end_object: builder.on_end_object(0);
+                    break;
+                }
+
+                if (frames_.size() == depth) return builder.result();
+            }
         }
 
-    private:
-        using char_traits = typename json::char_traits;
-        using char_type = typename char_traits::char_type;
-        using int_type = typename char_traits::int_type;
+        // gets the current token
+        [[nodiscard]] json_token token() const noexcept { return token_; }
 
-        struct input_stream
+        // gets the depth of nesting arrays and objects
+        [[nodiscard]] size_t depth() const noexcept { return frames_.size(); }
+
+        // tells whether to read the value of the current key, which the caller found duplicate in the current object (see `json_parse_option`):
+        // throws bad_format with `reject_duplicate_key`, returns false with `keep_first_duplicate_key` (skip the value), or true (the last value wins).
+        [[nodiscard]] bool accepts_duplicate_key() const
         {
-            CharInputIterator it_;
-            CharInputIterator const end_;
+            if (token_ != json_token::key) throw bad_access(); // not at a key
+            if (reader_.has_option(json_parse_option::reject_duplicate_key))
+                throw reader_type::make_bad_format("invalid object format: duplicate key \"" + std::string(string_.begin(), string_.end()) + "\"", std::nullopt, std::nullopt, key_offset_);
+            return !reader_.has_option(json_parse_option::keep_first_duplicate_key);
+        }
 
-            size_t current_position_char_{};
-            int current_position_line_{};
-            int current_position_column_{};
+    public: // values of the current token (throws bad_access if type is mismatch)
+        [[nodiscard]] json::js_boolean get_boolean() const { return token_ == json_token::boolean ? boolean_ : throw bad_access(); }
+        [[nodiscard]] json::js_integer get_integer() const { return token_ == json_token::integer ? integer_ : throw bad_access(); }
+        [[nodiscard]] json::js_floating get_floating() const { return token_ == json_token::floating ? floating_ : throw bad_access(); }
+        [[nodiscard]] json::js_number get_number() const { return token_ == json_token::integer ? static_cast<json::js_number>(integer_) : get_floating(); } // (integer or floating) as floating
+        [[nodiscard]] json::js_string_view get_string() const { return token_ == json_token::string || token_ == json_token::key ? string_ : throw bad_access(); } // string or key, valid until the next token
+
+    public: // reads the next token as value (throws bad_access if type is mismatch)
+        [[nodiscard]] json::js_boolean read_boolean() { return (void)next_token(), get_boolean(); }
+        [[nodiscard]] json::js_integer read_integer() { return (void)next_token(), get_integer(); }
+        [[nodiscard]] json::js_floating read_floating() { return (void)next_token(), get_floating(); }
+        [[nodiscard]] json::js_number read_number() { return (void)next_token(), get_number(); }
+        [[nodiscard]] json::js_string_view read_string() { return (void)next_token(), get_string(); }
+        [[nodiscard]] json::js_string_view read_key() { return next_token() == json_token::key ? string_ : throw bad_access(); }
 
-            // peeks current character
-            [[nodiscard]] int_type peek() const
+    private:
+        // reads a value at current position
+        json_token read_value()
+        {
+            auto& input = reader_.input_;
+            if (*input == '[' || *input == '{')
             {
-                return it_ != end_ ? char_traits::to_int_type(*it_) : char_traits::eof();
+                if (frames_.size() >= reader_.max_depth_)
+                    throw reader_.bad_format("invalid json format: too deeply nested (max depth " + std::to_string(reader_.max_depth_) + ")", *input);
+
+                const bool object = *input == '{';
+                ++input;
+                frames_.push_back(frame{object});
+                return token_ = object ? json_token::start_object : json_token::start_array;
             }
 
-            // eats a character
-            [[nodiscard]] int_type eat()
-            {
-                const int_type i = peek();
-                if (it_ != end_) ++it_;
+            scalar_handler handler{{}, *this};
+            reader_.read_scalar(handler);
+            return token_;
+        }
 
-                if (i != EOF)
-                {
-                    current_position_char_++;
+        json_token end_container(json_token token)
+        {
+            frames_.pop_back();
+            return token_ = token;
+        }
+    };
 
-                    current_position_column_++;
-                    if (i == '\n')
-                    {
-                        current_position_line_++;
-                        current_position_column_ = 0;
-                    }
-                }
+    json_cursor(json::json_string_view, json_parse_option, size_t) -> json_cursor<const json::char_type*>;
+    json_cursor(json::json_string_view, json_parse_option) -> json_cursor<const json::char_type*>;
+    json_cursor(json::json_string_view) -> json_cursor<const json::char_type*>;
 
-                return i;
-            }
+    /// json_path_filter: a set of JSON Pointers (RFC 6901, such as "/user/name" or "/items/0") selecting the elements to read.
+    /// `read` makes only the selected elements and their ancestors, skipping other arrays and objects with `json_cursor::skip_children_unchecked`
+    /// (so the skipped text is not validated). Arrays hold the elements up to the last selected index, with null for skipped ones.
+    class json_path_filter
+    {
+        // a node of the trie of pointers
+        struct path_node
+        {
+            json::js_string key{};           // member key, or array index
+            size_t index = npos;             // `key` as array index (npos if not a number)
+            bool selected{};                 // the whole element is selected
+            std::vector<size_t> children{};  // indices in `nodes_`
+            size_t last_index = npos;        // the largest `index` of children (npos if none)
+        };
 
-            // eats if current character is `chr`
-            [[nodiscard]] bool eat(int_type chr)
+        static constexpr size_t npos = static_cast<size_t>(-1);
+        std::vector<path_node> nodes_{path_node{}}; // [0]: the root
+
+    public:
+        json_path_filter(std::initializer_list<json::json_string_view> pointers) { for (auto&& p : pointers) add(p); }
+        explicit json_path_filter(const std::vector<json::json_string_view>& pointers) { for (auto&& p : pointers) add(p); }
+
+        // adds a pointer. throws bad_access if it is not a JSON Pointer.
+        void add(json::json_string_view pointer)
+        {
+            if (!pointer.empty() && pointer[0] != '/') throw bad_access("bad_access: invalid json pointer: \"" + std::string(pointer) + "\"");
+
+            size_t n = 0;
+            for (size_t i = 0; i < pointer.size();)
             {
-                return peek() == chr ? (void)eat(), true : false;
+                // decodes a reference token (`~1` -> `/`, `~0` -> `~`)
+                json::js_string key{};
+                for (i++; i < pointer.size() && pointer[i] != '/'; i++)
+                {
+                    if (pointer[i] != '~') key += pointer[i];
+                    else if (i + 1 < pointer.size() && (pointer[i + 1] == '0' || pointer[i + 1] == '1')) key += pointer[++i] == '0' ? '~' : '/';
+                    else throw bad_access("bad_access: invalid json pointer: \"" + std::string(pointer) + "\"");
+                }
+                n = child(n, std::move(key));
             }
+            nodes_[n].selected = true;
+        }
 
-            int_type operator *() const
+        // reads the next value from `cursor`, making only the selected elements and their ancestors.
+        // returns undefined if nothing is selected in it.
+        template <class CharInputIterator>
+        [[nodiscard]] json read(json_cursor<CharInputIterator>& cursor) const { return read(cursor, 0); }
+
+    private:
+        // gets the child of `nodes_[n]` for `key`, adding if not exists
+        size_t child(size_t n, json::js_string key)
+        {
+            for (size_t c : nodes_[n].children)
+                if (nodes_[c].key.compare(key) == 0) return c;
+
+            size_t index = npos;
+            if (!key.empty() && key.size() < 20 && std::all_of(key.begin(), key.end(), [](char c) { return c >= '0' && c <= '9'; }) && (key.size() == 1 || key[0] != '0'))
+                index = static_cast<size_t>(std::stoull(key));
+
+            nodes_.push_back(path_node{std::move(key), index});
+            nodes_[n].children.push_back(nodes_.size() - 1);
+            if (index != npos && (nodes_[n].last_index == npos || nodes_[n].last_index < index)) nodes_[n].last_index = index;
+            return nodes_.size() - 1;
+        }
+
+        template <class CharInputIterator>
+        json read(json_cursor<CharInputIterator>& cursor, size_t n) const
+        {
+            const path_node& node = nodes_[n];
+            if (node.selected) return cursor.read_json();
+
+            const size_t depth = cursor.depth();
+            switch (cursor.next_token())
             {
-                return peek();
+            case json_token::start_array:
+            {
+                json::js_array r{};
+                for (size_t i = 0;; i++)
+                {
+                    const auto c = std::find_if(node.children.begin(), node.children.end(), [&](size_t c) { return nodes_[c].index == i; });
+                    json value = c != node.children.end() ? read(cursor, *c) : (cursor.skip_value_unchecked(), json{});
+                    if (cursor.depth() == depth) break; // the end of array
+                    if (value.is_defined()) r.resize(i + 1, json(in_place_index::null)), r[i] = std::move(value); // (skipped ones are null)
+                    if (node.last_index == npos || i >= node.last_index) // the rest is not selected
+                    {
+                        while (cursor.skip_value_unchecked(), cursor.depth() > depth) { }
+                        break;
+                    }
+                }
+                return json(std::move(r));
             }
-
-            input_stream& operator ++()
+            case json_token::start_object:
             {
-                return (void)eat(), *this;
+                json::js_object r{};
+                while (cursor.next_token() == json_token::key)
+                {
+                    const auto key = cursor.get_string();
+                    const auto c = std::find_if(node.children.begin(), node.children.end(), [&](size_t c) { return json::js_string_view(nodes_[c].key).compare(key) == 0; });
+                    if (c == node.children.end())
+                    {
+                        cursor.skip_value_unchecked();
+                        continue;
+                    }
+                    if (json value = read(cursor, *c); value.is_defined()) r.insert_or_assign(nodes_[*c].key, std::move(value));
+                }
+                return json(std::move(r));
+            }
+            default:
+                cursor.skip_children_unchecked(); // (returns if not array or object)
+                return json{};
             }
+        }
+    };
 
-            auto operator ++(int)
+    /// json_mapped_file: read-only contents of a file, memory-mapped with `madvise(MADV_SEQUENTIAL)` if NANOJSON3_USE_MMAP is defined and POSIX `mmap` is available.
+    /// Otherwise (or if the file can't be mapped, such as a pipe), the contents are read into memory.
+    class json_mapped_file final
+    {
+        const json::char_type* mapping_{}; // mapped contents, nullptr if not mapped
+        size_t size_{};
+        json::json_string buffer_{};       // contents read into memory, if not mapped
+
+    public:
+        json_mapped_file() = default;
+
+        // opens `path`. throws std::system_error if it can't be read.
+        explicit json_mapped_file(const std::string& path)
+        {
+#if NANOJSON3_MMAP
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) throw std::system_error(errno, std::generic_category(), "nanojson3: cannot open \"" + path + "\"");
+
+            struct stat st{};
+            const bool regular = ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+            if (regular && st.st_size > 0) // (empty file can't be mapped)
             {
-                struct iter
+                const size_t size = static_cast<size_t>(st.st_size);
+                if (void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0); p != MAP_FAILED)
                 {
-                    int_type value;
-                    int_type operator *() const { return value; }
-                };
-
-                return iter{eat()};
+                    (void)::madvise(p, size, MADV_SEQUENTIAL);
+                    mapping_ = static_cast<const json::char_type*>(p);
+                    size_ = size;
+                }
+            }
+            ::close(fd);
+            if (mapping_ || (regular && st.st_size == 0)) return;
+#endif
+            errno = 0;
+            std::basic_filebuf<json::char_type> file{};
+            if (!file.open(path, std::ios::in | std::ios::binary))
+                throw std::system_error(errno ? errno : static_cast<int>(std::errc::io_error), std::generic_category(), "nanojson3: cannot open \"" + path + "\"");
+
+            // reads into `buffer_` directly, growing it twice
+            size_t size = 0;
+            for (std::streamsize n = 0; size == buffer_.size(); size += static_cast<size_t>(n))
+            {
+                buffer_.resize((std::max)(buffer_.size() * 2, size_t{65536}));
+                n = file.sgetn(buffer_.data() + size, static_cast<std::streamsize>(buffer_.size() - size));
             }
-        } input_;
+            buffer_.resize(size);
+        }
 
-        json_parse_option option_bits_{};
-        json::js_string string_input_buffer_{};
+        json_mapped_file(const json_mapped_file& other) = delete;
+        json_mapped_file& operator=(const json_mapped_file& other) = delete;
 
-        // ctor
-        json_reader(CharInputIterator begin, CharInputIterator end, json_parse_option option) : input_{begin, end}, option_bits_(option), string_input_buffer_(256, '\0') { }
+        json_mapped_file(json_mapped_file&& other) noexcept
+            : mapping_(std::exchange(other.mapping_, nullptr)), size_(std::exchange(other.size_, 0)), buffer_(std::move(other.buffer_)) { }
 
-        // executes parsing
-        [[nodiscard]] json execute()
+        json_mapped_file& operator=(json_mapped_file&& other) noexcept
         {
-            eat_utf8bom();
-            eat_whitespaces();
-            return read_element();
+            if (this != &other)
+            {
+                unmap();
+                mapping_ = std::exchange(other.mapping_, nullptr);
+                size_ = std::exchange(other.size_, 0);
+                buffer_ = std::move(other.buffer_);
+            }
+            return *this;
         }
 
-        // gets the option bit enabled.
-        [[nodiscard]] bool has_option(json_parse_option bit) const noexcept
+        ~json_mapped_file() { unmap(); }
+
+        // gets the contents
+        [[nodiscard]] json::json_string_view view() const noexcept { return mapping_ ? json::json_string_view(mapping_, size_) : json::json_string_view(buffer_); }
+
+        // true if the contents are memory-mapped
+        [[nodiscard]] bool mapped() const noexcept { return mapping_ != nullptr; }
+
+    private:
+        void unmap() noexcept
         {
-            return (option_bits_ & bit) != json_parse_option::none;
+#if NANOJSON3_MMAP
+            if (mapping_) (void)::munmap(const_cast<json::char_type*>(mapping_), size_);
+#endif
+            mapping_ = nullptr;
+            size_ = 0;
         }
+    };
 
-        // reads single node from the stream.
-        json read_element()
+    class json_lazy_document;
+
+    /// json_lazy_view: read-only json element in json_lazy_document, with the same accessors as json_view.
+    /// An array or object holds only its source text until its children are first accessed (by `value()`, `as_array()`, `operator[]` etc.).
+    /// Then it reads one level of children, holding their arrays and objects as source text found by `json_cursor::skip_children_unchecked`.
+    /// So malformed text is reported (with the offset in the source text) when, and only if, the enclosing array or object is read.
+    /// `get_type()` and `is_*()` don't read children. Reading children is not thread-safe: read the accessed elements before sharing the document.
+    class json_lazy_view final : public json_view_accessors<json_lazy_view>
+    {
+    public: // typedefs
+        using char_type = json::char_type;
+        using char_traits = json::char_traits;
+
+        using js_undefined = json::js_undefined;
+        using js_null = json::js_null;
+        using js_boolean = json::js_boolean;
+        using js_integer = json::js_integer;
+        using js_floating = json::js_floating;
+        using js_number = json::js_number;
+        using js_string = json::js_string_view;
+        using js_string_view = json::js_string_view;
+        using js_array_index = json::js_array_index;
+        using js_array_index_view = json::js_array_index_view;
+        using js_array = std::vector<json_lazy_view>;
+        using js_object_key = json::js_object_key_view;
+        using js_object_key_view = json::js_object_key_view;
+        using js_object_kvp = internal::key_value_pair<js_object_key, json_lazy_view>;
+        using js_object = internal::key_value_store<js_object_key, json_lazy_view, std::equal_to<>, std::vector<js_object_kvp>>;
+        using js_raw_number = internal::raw_number<js_string_view>;
+        using js_variant = std::variant<js_undefined, js_null, js_boolean, js_integer, js_floating, js_string, js_array, js_object, js_raw_number>;
+        template <json_type_index ti> using js_type_by_index = std::variant_alternative_t<static_cast<size_t>(ti), js_variant>;
+
+    private:
+        // shared by the elements of a document
+        struct context
         {
-            switch (*input_)
-            {
-            case 'n': // `null`
-                if (!input_.eat('n')) throw bad_format("invalid 'null' literal: expected 'n'", *input_);
-                if (!input_.eat('u')) throw bad_format("invalid 'null' literal: expected 'u'", *input_);
-                if (!input_.eat('l')) throw bad_format("invalid 'null' literal: expected 'l'", *input_);
-                if (!input_.eat('l')) throw bad_format("invalid 'null' literal: expected 'l'", *input_);
-                return json{in_place_index::null};
+            js_string_view source;
+            json_parse_option option;
+            size_t max_depth;                            // arrays and objects nested deeper are rejected when read
+            internal::string_arena<char_type> storage{}; // strings decoded from escape sequences
+            json_mapped_file file{};                     // owns the source text, if read from a file
+        };
 
-            case 't': // `true`
-                if (!input_.eat('t')) throw bad_format("invalid 'true' literal: expected 't'", *input_);
-                if (!input_.eat('r')) throw bad_format("invalid 'true' literal: expected 'r'", *input_);
-                if (!input_.eat('u')) throw bad_format("invalid 'true' literal: expected 'u'", *input_);
-                if (!input_.eat('e')) throw bad_format("invalid 'true' literal: expected 'e'", *input_);
-                return json{in_place_index::boolean, true};
+        mutable js_variant value_{};         // an empty array or object until its children are read
+        mutable const char_type* unread_{};  // `[unread_, unread_end_)`: the source text of the array or object not read yet, nullptr if read
+        const char_type* unread_end_{};
+        size_t depth_{}; // the number of enclosing arrays and objects
+        context* context_{};
+        template <class Node> friend class json_document_builder;
+        friend class json_lazy_document;
+        friend class json_view_accessors<json_lazy_view>;
 
-            case 'f': // `false`
-                if (!input_.eat('f')) throw bad_format("invalid 'false' literal: expected 'f'", *input_);
-                if (!input_.eat('a')) throw bad_format("invalid 'false' literal: expected 'a'", *input_);
-                if (!input_.eat('l')) throw bad_format("invalid 'false' literal: expected 'l'", *input_);
-                if (!input_.eat('s')) throw bad_format("invalid 'false' literal: expected 's'", *input_);
-                if (!input_.eat('e')) throw bad_format("invalid 'false' literal: expected 'e'", *input_);
-                return json{in_place_index::boolean, false};
+        json_lazy_view(const char_type* begin, const char_type* end, bool object, size_t depth, context* context)
+            : value_(object ? js_variant(js_object{}) : js_variant(js_array{})), unread_(begin), unread_end_(end), depth_(depth), context_(context) { }
 
-            case '+':
-            case '-':
-            case '0':
-            case '1':
-            case '2':
-            case '3':
-            case '4':
-            case '5':
-            case '6':
-            case '7':
-            case '8':
-            case '9':
-                return read_number();
+        // reads the children if not yet
+        void read() const;
 
-            case '"':
-                return read_string();
+        // reads the next value (in `depth` arrays and objects) into `builder`, holding array or object as source text. returns false if the array ends.
+        // throws bad_format if an array or object is nested deeper than `context->max_depth`.
+        static bool read_value(json_cursor<const char_type*>& cursor, json_document_builder<json_lazy_view>& builder, size_t depth, context* context);
 
-            case '[':
-                return read_array();
+        using const_json_lazy_view_value_ref = json::json_value_reference_container<const js_variant&>;
 
-            case '{':
-                return read_object();
+        // accesses the value without reading children
+        [[nodiscard]] const_json_lazy_view_value_ref peek() const noexcept { return const_json_lazy_view_value_ref{value_}; }
 
-            default:
-                break;
-            }
+    public: // constructors
+        json_lazy_view() = default;
+        json_lazy_view(const json_lazy_view& other) = default;
+        json_lazy_view(json_lazy_view&& other) noexcept = default;
+        json_lazy_view& operator=(const json_lazy_view& other) = default;
+        json_lazy_view& operator=(json_lazy_view&& other) noexcept = default;
+        ~json_lazy_view() = default;
 
-            throw bad_format("invalid json format: expected an element", *input_);
-        }
+        template <json_type_index type_index, class... Args>
+        json_lazy_view(in_place_index_t<type_index> index, Args&&... args) : value_(index, std::forward<Args>(args)...) { }
 
-        // reads integer or floating
-        json read_number()
+    public: // conversion
+        // makes a `json` owning copies of all values, reading all arrays and objects.
+        [[nodiscard]] json to_json() const;
+
+    public: // undefined_reference
+        [[nodiscard]] static const json_lazy_view& undefined_reference() noexcept
         {
-            constexpr auto is_digit = [](int_type i)-> bool { return i >= '0' && i <= '9'; }; // locale-independent is_digit
+            static json_lazy_view undefined{};
+            return undefined;
+        }
 
-            char buffer[128]{};
-            char* p = buffer;
-            char* const integer_limit = buffer + 60;
-            char* const fraction_limit = buffer + 64;
-            char* const decimal_limit = buffer + 128;
+    public: // accessors (read children, so may throw bad_format)
+        [[nodiscard]] const_json_lazy_view_value_ref value() const { return read(), peek(); }
+        [[nodiscard]] const_json_lazy_view_value_ref operator *() const { return value(); }
+        [[nodiscard]] const_json_lazy_view_value_ref operator ->() const { return value(); }
+        [[nodiscard]] const json_lazy_view& operator [](js_array_index_view index) const; // array[index]
+        [[nodiscard]] const json_lazy_view& operator [](js_object_key_view key) const;    // object[key]
 
-            int exp_offset = 0;
-            constexpr auto maximum_exp_offset = (std::numeric_limits<decltype(exp_offset)>::max)();
-            constexpr auto minimum_exp_offset = (std::numeric_limits<decltype(exp_offset)>::lowest)();
+    };
 
-            bool integer_type = true;
+    inline void json_lazy_view::read() const
+    {
+        if (!unread_) return;
 
-            // parse integer part
-            {
-                if (input_.eat('-')) { *p++ = '-'; }                                                  // minus sign
-                if (has_option(json_parse_option::allow_number_with_plus_sign) && input_.eat('+')) {} // ignore plus sign
+        json_cursor<const char_type*> cursor(unread_, unread_end_, context_->option);
+        cursor.reader_.offset_base_ = static_cast<size_t>(unread_ - context_->source.data());
+        json_document_builder<json_lazy_view> builder(context_->source, &context_->storage, context_->option);
 
-                if (input_.eat('0')) { *p++ = '0'; } // put '0', leading zeros are not allowed in JSON.
-                else if (is_digit(*input_))          // not zero
-                {
-                    while (is_digit(*input_))
-                        if (p < integer_limit) *p++ = static_cast<char_type>(*input_++);  // put digit
-                        else if (exp_offset < maximum_exp_offset) ++exp_offset, ++input_; // drop digit
-                        else throw bad_format("invalid number format: too long integer sequence");
-                }
-                else throw bad_format("invalid number format: expected a digit", *input_);
+        size_t count = 0;
+        if (cursor.next_token() == json_token::start_object)
+        {
+            builder.on_start_object();
+            for (; cursor.next_token() == json_token::key; count++)
+            {
+                builder.on_key(cursor.get_string(), cursor.key_offset_);
+                read_value(cursor, builder, depth_ + 1, context_);
             }
+            builder.on_end_object(count);
+        }
+        else
+        {
+            builder.on_start_array();
+            while (read_value(cursor, builder, depth_ + 1, context_)) count++;
+            builder.on_end_array(count);
+        }
 
-            if (input_.eat('.')) // accept fraction point part
+        value_ = std::move(builder.result().value_);
+        unread_ = nullptr;
+    }
+
+    inline bool json_lazy_view::read_value(json_cursor<const char_type*>& cursor, json_document_builder<json_lazy_view>& builder, size_t depth, context* context)
+    {
+        switch (cursor.next_token())
+        {
+        case json_token::null: builder.on_null();
+            return true;
+        case json_token::boolean: builder.on_boolean(cursor.get_boolean());
+            return true;
+        case json_token::integer: builder.on_integer(cursor.get_integer());
+            return true;
+        case json_token::floating: builder.on_floating(cursor.get_floating());
+            return true;
+        case json_token::string: builder.on_string(cursor.get_string());
+            return true;
+        case json_token::start_array:
+        case json_token::start_object:
+        {
+            auto& input = cursor.reader_.input_;
+            const bool object = cursor.token() == json_token::start_object;
+            const char_type* begin = input.it_ - 1; // at the opening bracket
+            if (depth >= context->max_depth)
             {
-                assert(p < fraction_limit);
-                *p++ = '.'; // put decimal point
-                integer_type = false;
+                input.it_ = begin;
+                throw cursor.reader_.bad_format("invalid json format: too deeply nested (max depth " + std::to_string(context->max_depth) + ")", *input);
+            }
 
-                if (is_digit(*input_))
-                {
-                    // if integer part is zero (parse '-0.0000...ddd')
-                    if ((buffer[0] == '0') || (buffer[0] == '-' && buffer[1] == '0'))
-                    {
-                        while (*input_ == '0')
-                            if (exp_offset > minimum_exp_offset) --exp_offset, ++input_; // drop '0'
-                            else throw bad_format("invalid number format: too long integer sequence");
-                    }
+            cursor.skip_children_unchecked();
+            builder.on_value(json_lazy_view(begin, input.it_, object, depth, context));
+            return true;
+        }
+        default: // end_array
+            return false;
+        }
+    }
 
-                    while (is_digit(*input_))
-                    {
-                        if (p < fraction_limit) *p++ = static_cast<char_type>(*input_++); // put digit
-                        else ++input_;                                                    // drop digit
-                    }
-                }
-                else throw bad_format("invalid number format: expected a digit", *input_);
-            }
+    // const array[index]
+    inline const json_lazy_view& json_lazy_view::operator[](js_array_index_view index) const
+    {
+        if (const auto a = value().as_array())
+            if (index < a->size())
+                return a->operator[](index);
 
-            if (*input_ == 'e' || *input_ == 'E') // accept exponent part
-            {
-                ++input_; // 'e'
-                integer_type = false;
+        return undefined_reference();
+    }
+
+    // const object[key]
+    inline const json_lazy_view& json_lazy_view::operator[](js_object_key_view key) const
+    {
+        if (const auto o = value().as_object())
+            if (const auto it = o->find(key); it != o->end())
+                return it->second;
+
+        return undefined_reference();
+    }
+
+    inline json json_lazy_view::to_json() const { return copy_json(*this); }
+
+    /// json_lazy_document: owns a json_lazy_view tree read on demand from the source text (see `json_lazy_view`),
+    /// and the storage of strings decoded from escape sequences. The source text must outlive the document.
+    class json_lazy_document final
+    {
+        std::unique_ptr<json_lazy_view::context> context_{};
+        json_lazy_view root_{};
+
+    public:
+        // reads the root element, holding it as source text if it is an array or object.
+        // arrays and objects nested deeper than `max_depth` are rejected with bad_format when their parent is read.
+        explicit json_lazy_document(json::json_string_view source, json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH)
+            : context_(std::make_unique<json_lazy_view::context>(json_lazy_view::context{source, loose, max_depth}))
+        {
+            read_root();
+        }
+
+        // reads the root element of `file`, owning it.
+        explicit json_lazy_document(json_mapped_file file, json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH)
+            : context_(std::make_unique<json_lazy_view::context>(json_lazy_view::context{{}, loose, max_depth}))
+        {
+            context_->file = std::move(file);
+            context_->source = context_->file.view();
+            read_root();
+        }
+
+        json_lazy_document(const json_lazy_document& other) = delete;
+        json_lazy_document(json_lazy_document&& other) noexcept = default;
+        json_lazy_document& operator=(const json_lazy_document& other) = delete;
+        json_lazy_document& operator=(json_lazy_document&& other) noexcept = default;
+        ~json_lazy_document() = default;
 
-                char exp_part[32]{};
-                char* exp = exp_part;
-                char* const exp_limit = exp_part + std::size(exp_part);
+        // gets the root element
+        [[nodiscard]] const json_lazy_view& root() const noexcept { return root_; }
 
-                // read
+        // accesses the root element
+        [[nodiscard]] const json_lazy_view& operator *() const noexcept { return root_; }
+        [[nodiscard]] const json_lazy_view* operator ->() const noexcept { return &root_; }
+        [[nodiscard]] const json_lazy_view& operator [](json_lazy_view::js_array_index_view index) const { return root_[index]; } // array[index]
+        [[nodiscard]] const json_lazy_view& operator [](json_lazy_view::js_object_key_view key) const { return root_[key]; }    // object[key]
+        operator const json_lazy_view&() const noexcept { return root_; }
 
-                if (input_.eat('-')) { *exp++ = '-'; }
-                else if (input_.eat('+')) {} // drop '+'
+    private:
+        void read_root()
+        {
+            const json::json_string_view source = context_->source;
+            json_cursor<const json::char_type*> cursor(source, context_->option);
+            json_document_builder<json_lazy_view> builder(source, &context_->storage, context_->option);
+            json_lazy_view::read_value(cursor, builder, 0, context_.get());
+            root_ = builder.result();
+        }
+    };
 
-                if (is_digit(*input_))
-                {
-                    while (is_digit(*input_))
-                    {
-                        if (exp < exp_limit) *exp++ = static_cast<char_type>(*input_++); // put digit
-                        else ++input_;                                                   // drop digit (it must be overflow, handle later)
-                    }
-                }
-                else throw bad_format("invalid number format: expected a digit", *input_);
+    /// json_push_parser: resumable parser receiving the source text in chunks.
+    /// Keeps its state in an explicit stack and suspends at any byte (even in a token),
+    /// then notifies elements to `Handler` (see `json_event_handler`; builds `json` by default).
+    /// Errors are reported with the offset in the whole source text.
+    /// usage:
+    ///     njs3::json_push_parser parser{};
+    ///     while (receive(chunk)) parser.feed(chunk);
+    ///     parser.finish();
+    ///     njs3::json json = parser.result();
+    template <class Handler = json_document_builder<json>>
+    class json_push_parser
+    {
+        using reader_type = json::json_reader<const json::char_type*>;
+        using char_type = json::char_type;
+        using int_type = json::char_traits::int_type;
 
-                // parse exponent
-                int exp_value{};
-                auto [ptr, ec] = std::from_chars(exp_part, exp, exp_value, 10);
+        // what is expected next
+        enum struct state : unsigned char
+        {
+            start,      // BOM or the root element
+            bom_bb,     // 2nd byte of BOM
+            bom_bf,     // 3rd byte of BOM
+            element,    // an element (root or object member value)
+            array_first,
+            array_after_element,
+            array_after_comma,
+            object_first,
+            object_after_key,
+            object_after_element,
+            object_after_comma,
+            done, // the root element is completed, the rest is ignored (same as json_reader)
+        };
 
-                if (ec == std::errc{} && ptr == exp)
-                {
-                    exp_offset = exp_offset > 0 && exp_value > maximum_exp_offset - exp_offset ? maximum_exp_offset : exp_offset < 0 && exp_value < minimum_exp_offset - exp_offset ? minimum_exp_offset : exp_offset + exp_value;
-                }
-                else if (ec == std::errc::result_out_of_range && ptr == exp)
-                {
-                    exp_offset = exp_part[0] == '-' ? maximum_exp_offset : minimum_exp_offset;
-                }
-                else // other error (bug)
-                {
-                    assert(false);
-                    throw bad_format("invalid number format: unexpected parse error "); // unexpected
-                }
-            }
+        // token being read
+        enum struct token_kind : unsigned char
+        {
+            none,
+            literal,
+            number,
+            string,
+            quoted_key,
+            unquoted_key,
+        };
 
-            if (exp_offset != 0) // append parsed exponent part to buffer
-            {
-                integer_type = false;
-                assert(p < decimal_limit);
-                if (p < decimal_limit) *p++ = 'e';
-                auto [ptr, ec] = std::to_chars(p, decimal_limit, exp_offset, 10);
-                if (ec != std::errc{}) throw bad_format("invalid number format: unexpected error.");
-                p = ptr;
-            }
+        enum struct comment_state : unsigned char
+        {
+            none,
+            slash,      // after `/`
+            block,      // in `/* */`
+            block_star, // after `*` in `/* */`
+            line,       // in `//`
+        };
 
-            // try to parse as integer type
-            if (integer_type)
-            {
-                json::js_integer ret{};
-                auto [ptr, ec] = std::from_chars(buffer, p, ret, 10);
-                if (ec == std::errc{} && ptr == p) return json{in_place_index::integer, ret}; // integer OK
-            }
+        // array or object being read
+        struct frame
+        {
+            bool object{};
+            size_t count{};
+        };
 
-            // try to parse as floating type (should succeed)
-            {
-                json::js_floating ret{};
-#if (defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L) // compiler has floating-point from_chars
-                auto [ptr, ec] = std::from_chars(buffer, p, ret);
-#else // use fallback implementation
-                std::istringstream tmp{std::string(buffer, p)};
-                tmp.imbue(std::locale::classic());
-                tmp >> ret;
-                std::errc ec = !tmp ? std::errc::result_out_of_range : std::errc{}; // if fails, assume it must be out of range.
-                const char* ptr = !tmp ? p : tmp.eof() ? p : buffer + tmp.tellg();
-#endif
+        Handler handler_{};
+        json_parse_option option_bits_{};
+        size_t max_depth_{};
+        state state_ = state::start;
+        std::vector<frame> frames_{};
 
-                assert(ec == std::errc{} || ec == std::errc::result_out_of_range);
-                assert(ptr == p);
+        comment_state comment_ = comment_state::none;
 
-                if (ptr == p && ec == std::errc{}) return json{in_place_index::floating, ret}; // floating OK
+        token_kind token_ = token_kind::none;
+        bool token_escape_{};                // the last character of string token was unescaped `\`
+        size_t token_offset_{};              // offset of the token in the source text
+        const char_type* token_begin_{};     // the beginning of the token in current chunk
+        json::js_string token_buffer_{};     // the token spanning chunks
+        json::js_string decode_buffer_{};    // (buffer for json_reader decoding strings)
 
-                if (ec == std::errc::result_out_of_range) // overflow or underflow
-                {
-                    if (exp_offset >= 0) // overflow
-                        return json{in_place_index::floating, buffer[0] != '-' ? +std::numeric_limits<json::js_floating>::infinity() : -std::numeric_limits<json::js_floating>::infinity()};
-                    else // underflow
-                        return json{in_place_index::floating, buffer[0] != '-' ? +static_cast<json::js_floating>(+0.0) : -static_cast<json::js_floating>(-0.0)};
-                }
-            }
+        size_t chunk_offset_{};              // offset of current chunk in the source text
+        const char_type* chunk_begin_{};
 
-            assert(false);
-            throw bad_format("invalid number format: failed to parse");
+        // makes the default handler, giving `loose` if it takes (e.g. json_document_builder for duplicate keys)
+        static Handler make_handler(json_parse_option loose)
+        {
+            if constexpr (std::is_constructible_v<Handler, json_parse_option>) return Handler(loose);
+            else return Handler{};
         }
 
-        // reads quoated string
-        json read_string()
-        {
-            // check quote character
-            assert(*input_ == '"');
-            int_type quote = *input_++; // '"'
+    public:
+        // arrays and objects nested deeper than `max_depth` are rejected with bad_format.
+        explicit json_push_parser(json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH) : handler_(make_handler(loose)), option_bits_(loose), max_depth_(max_depth) { }
+        explicit json_push_parser(Handler handler, json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH) : handler_(std::move(handler)), option_bits_(loose), max_depth_(max_depth) { }
 
-            auto& ret = string_input_buffer_;
-            ret.clear();
+        // gets the handler
+        [[nodiscard]] Handler& handler() noexcept { return handler_; }
 
-            while (true)
-            {
-                if (input_.eat('\\')) // escape sequence found?
-                {
-                    if (*input_ == 'n') ret += '\n';
-                    else if (*input_ == 't') ret += '\t';
-                    else if (*input_ == 'b') ret += '\b';
-                    else if (*input_ == 'f') ret += '\f';
-                    else if (*input_ == 'r') ret += '\r';
-                    else if (*input_ == '\\') ret += '\\';
-                    else if (*input_ == '/') ret += '/';
-                    else if (*input_ == '\"') ret += '\"';
-                    else if (*input_ == '\'') ret += '\'';
-                    else if (*input_ == 'u') // \uXXXX is converted to UTF-8 sequence
-                    {
-                        auto hex = [&](int_type chr)
-                        {
-                            if (chr >= '0' && chr <= '9') { return chr - '0'; }
-                            if (chr >= 'A' && chr <= 'F') { return chr - 'A' + 10; }
-                            if (chr >= 'a' && chr <= 'f') { return chr - 'a' + 10; }
-                            throw bad_format("invalid string format: expected hexadecimal digit for \\u????", chr);
-                        };
+        // gets the result of the handler (e.g. built json)
+        template <class H = Handler>
+        [[nodiscard]] auto result() -> decltype(std::declval<H&>().result()) { return handler_.result(); }
 
-                        int code = 0;
-                        code = code << 4 | hex(*++input_);
-                        code = code << 4 | hex(*++input_);
-                        code = code << 4 | hex(*++input_);
-                        code = code << 4 | hex(*++input_);
+        // gets true if the root element is completed
+        [[nodiscard]] bool done() const noexcept { return state_ == state::done; }
 
-                        if (code < 0x80) // 7 bit
-                        {
-                            ret += static_cast<char>((code >> 0 & 0x7F) | 0x00);
-                        }
-                        else if (code < 0x0800) // 11 bit
-                        {
-                            ret += static_cast<char>((code >> 6 & 0x1f) | 0xC0);
-                            ret += static_cast<char>((code >> 0 & 0x3f) | 0x80);
-                        }
-                        else if ((code & 0xF800) == 0xD800) // surrogate pair
-                        {
-                            // assume next surrogate is following.
-                            if (*++input_ != '\\') throw bad_format("invalid string format: expected surrogate pair", *input_);
-                            if (*++input_ != 'u') throw bad_format("invalid string format: expected surrogate pair", *input_);
+        // reads a chunk of the source text
+        void feed(json::json_string_view chunk)
+        {
+            const char_type* p = chunk.data();
+            const char_type* const end = p + chunk.size();
+            chunk_begin_ = p;
+            if (token_ != token_kind::none) token_begin_ = p; // continues the token
 
-                            int code2 = 0;
-                            code2 = code2 << 4 | hex(*++input_);
-                            code2 = code2 << 4 | hex(*++input_);
-                            code2 = code2 << 4 | hex(*++input_);
-                            code2 = code2 << 4 | hex(*++input_);
+            while (p != end)
+            {
+                if (token_ != token_kind::none) p = read_token(p, end);
+                else if (comment_ != comment_state::none) p = read_comment(p, end);
+                else if (state_ == state::done) break;
+                else if (state_ == state::start || state_ == state::bom_bb || state_ == state::bom_bf) p = read_bom(p);
+                else if ((p = internal::scan::skip_whitespaces(p, end)) != end) p = read_structure(p);
+            }
 
-                            if ((code & 0xFC00) == 0xDC00 && (code2 & 0xFC00) == 0xD800)
-                                std::swap(code, code2);
+            if (token_ != token_kind::none) token_buffer_.append(token_begin_, end); // suspends in the token
+            chunk_offset_ += chunk.size();
+        }
 
-                            if ((code & 0xFC00) == 0xD800 && (code2 & 0xFC00) == 0xDC00)
-                                code = ((code & 0x3FF) << 10 | (code2 & 0x3FF)) + 0x10000; // 21 bit
-                            else
-                                throw bad_format("invalid string format: invalid surrogate pair sequence");
+        // notifies the end of the source text. throws bad_format if the root element is incomplete.
+        void finish()
+        {
+            chunk_begin_ = nullptr;
+            if (token_ != token_kind::none) complete_token(token_buffer_.data(), token_buffer_.data() + token_buffer_.size());
+            comment_ = comment_state::none;
 
-                            ret += static_cast<char>((code >> 18 & 0x07) | 0xF0);
-                            ret += static_cast<char>((code >> 12 & 0x3f) | 0x80);
-                            ret += static_cast<char>((code >> 6 & 0x3f) | 0x80);
-                            ret += static_cast<char>((code >> 0 & 0x3f) | 0x80);
-                        }
-                        else // 16 bit
-                        {
-                            ret += static_cast<char>((code >> 12 & 0x0f) | 0xE0);
-                            ret += static_cast<char>((code >> 6 & 0x3f) | 0x80);
-                            ret += static_cast<char>((code >> 0 & 0x3f) | 0x80);
-                        }
-                    }
-                    else
-                    {
-                        throw bad_format("invalid string format: invalid escape sequence");
-                    }
-                }
-                else if (input_.eat(quote)) break; // end of string.
-                else if (*input_ == EOF) throw bad_format("invalid string format: unexpected eof");
-                else if (*input_ < 0x20 || *input_ == 0x7F) throw bad_format("invalid string format: control character is not allowed", *input_);
-                else if (*input_ == '/' && !has_option(json_parse_option::allow_unescaped_forward_slash)) throw bad_format("invalid string format: unescaped '/' is not allowed");
-                else ret += static_cast<char_type>(*input_); // OK. normal character.
-                ++input_;
+            constexpr int_type eof = std::char_traits<char_type>::eof();
+            switch (state_)
+            {
+            case state::done: return;
+            case state::bom_bb: throw bad_format("invalid json format: UTF-8 BOM sequence expected... 0xBB", eof);
+            case state::bom_bf: throw bad_format("invalid json format: UTF-8 BOM sequence expected... 0xBF", eof);
+            case state::array_after_element: throw bad_format("invalid array format: ',' or ']' expected", eof);
+            case state::object_after_key: throw bad_format("invalid object format: expected a ':'", eof);
+            case state::object_after_element: throw bad_format("invalid object format: expected ',' or '}'", eof);
+            case state::object_first:
+            case state::object_after_comma:
+                if (has_option(json_parse_option::allow_unquoted_object_key)) throw bad_format("invalid object format: expected a ':'", eof);
+                throw bad_format("invalid object format: expected object key", eof);
+            default: throw bad_format("invalid json format: expected an element", eof);
             }
+        }
 
-            return json{in_place_index::string, ret}; // copy
+    private:
+        // gets the option bit enabled.
+        [[nodiscard]] bool has_option(json_parse_option bit) const noexcept
+        {
+            return (option_bits_ & bit) != json_parse_option::none;
         }
 
-        // reads array `[...]`
-        json read_array()
+        // gets offset of `p` in the source text
+        [[nodiscard]] size_t offset_of(const char_type* p) const noexcept
         {
-            if (!input_.eat('[')) throw bad_format("logic error (bug)");
+            return chunk_offset_ + (chunk_begin_ ? static_cast<size_t>(p - chunk_begin_) : 0);
+        }
 
-            json result(in_place_index::array);        // make empty array
-            json::js_array& ret = *result->as_array(); // and get reference to it.
+        // makes a bad_format exception at `p` (or the end of the source text)
+        [[nodiscard]] exceptions::bad_format bad_format(std::string_view reason, int_type but_encountered, const char_type* p = nullptr) const
+        {
+            return reader_type::make_bad_format(reason, but_encountered, std::nullopt, p ? offset_of(p) : chunk_offset_);
+        }
 
-            eat_whitespaces();
+        // reads UTF-8 BOM `EFBBBF` if allowed
+        const char_type* read_bom(const char_type* p)
+        {
+            const int_type c = std::char_traits<char_type>::to_int_type(*p);
+            switch (state_)
+            {
+            case state::start:
+                state_ = state::element;
+                if (c != 0xEF) return p;
+                if (!has_option(json_parse_option::allow_utf8_bom)) throw bad_format("invalid json format: expected an element. (UTF-8 BOM not allowed)", c, p);
+                state_ = state::bom_bb;
+                return p + 1;
+            case state::bom_bb:
+                if (c != 0xBB) throw bad_format("invalid json format: UTF-8 BOM sequence expected... 0xBB", c, p);
+                state_ = state::bom_bf;
+                return p + 1;
+            default:
+                if (c != 0xBF) throw bad_format("invalid json format: UTF-8 BOM sequence expected... 0xBF", c, p);
+                state_ = state::element;
+                return p + 1;
+            }
+        }
 
-            if (input_.eat(']')) return result; // empty array
+        // reads comment body
+        const char_type* read_comment(const char_type* p, const char_type* end)
+        {
+            switch (comment_)
+            {
+            case comment_state::slash:
+                comment_ = *p == '*' ? comment_state::block : *p == '/' ? comment_state::line : comment_state::none;
+                return comment_ != comment_state::none ? p + 1 : p; // `/` followed by other character is ignored (same as json_reader)
+            case comment_state::block:
+                p = internal::scan::find(p, end, '*');
+                if (p != end) comment_ = comment_state::block_star, ++p;
+                return p;
+            case comment_state::block_star:
+                comment_ = *p == '/' ? comment_state::none : *p == '*' ? comment_state::block_star : comment_state::block;
+                return p + 1;
+            default:
+                p = internal::scan::find(p, end, '\n');
+                if (p != end) comment_ = comment_state::none, ++p;
+                return p;
+            }
+        }
 
-            ret.reserve(8);
-            while (true)
+        // reads a structural character at `p` (not a white space)
+        const char_type* read_structure(const char_type* p)
+        {
+            const char_type c = *p;
+            if (c == '/' && has_option(json_parse_option::allow_comment))
             {
-                // read value
-                ret.push_back(read_element());
+                comment_ = comment_state::slash;
+                return p + 1;
+            }
 
-                eat_whitespaces();
+            switch (state_)
+            {
+            case state::array_first:
+                if (c == ']') return end_container(p);
+                return start_element(p);
+
+            case state::array_after_element:
+                if (c == ',') return state_ = state::array_after_comma, p + 1;
+                if (c == ']') return end_container(p);
+                throw bad_format("invalid array format: ',' or ']' expected", c, p);
+
+            case state::array_after_comma:
+                if (c != ']') return start_element(p);
+                if (has_option(json_parse_option::allow_trailing_comma)) return end_container(p);
+                throw bad_format("invalid array format: expected an element (trailing comma not allowed)", c, p);
+
+            case state::object_first:
+                if (c == '}') return end_container(p);
+                return start_key(p);
+
+            case state::object_after_key:
+                if (c == ':') return state_ = state::element, p + 1;
+                throw bad_format("invalid object format: expected a ':'", c, p);
+
+            case state::object_after_element:
+                if (c == ',') return state_ = state::object_after_comma, p + 1;
+                if (c == '}') return end_container(p);
+                throw bad_format("invalid object format: expected ',' or '}'", c, p);
+
+            case state::object_after_comma:
+                if (c != '}') return start_key(p);
+                if (has_option(json_parse_option::allow_trailing_comma)) return end_container(p);
+                throw bad_format("invalid object format: expected an element (trailing comma not allowed)", c, p);
 
-                if (input_.eat(','))
-                {
-                    eat_whitespaces();
-                    if (has_option(json_parse_option::allow_trailing_comma) && input_.eat(']')) break;
-                    else if (*input_ == ']') throw bad_format("invalid array format: expected an element (trailing comma not allowed)", *input_);
-                }
-                else if (input_.eat(']')) break;
-                else throw bad_format("invalid array format: ',' or ']' expected", *input_);
+            default:
+                return start_element(p);
             }
-
-            return result;
         }
 
-        // reads object `{...}`
-        json read_object()
+        // starts an element at `p`
+        const char_type* start_element(const char_type* p)
         {
-            if (!input_.eat('{')) throw bad_format("logic error (bug)");
+            if ((*p == '[' || *p == '{') && frames_.size() >= max_depth_)
+                throw bad_format("invalid json format: too deeply nested (max depth " + std::to_string(max_depth_) + ")", *p, p);
 
-            json result(in_place_index::object);         // make empty object
-            json::js_object& ret = *result->as_object(); // and get reference to it.
+            switch (*p)
+            {
+            case '[':
+                handler_.on_start_array();
+                frames_.push_back(frame{false});
+                state_ = state::array_first;
+                return p + 1;
 
-            eat_whitespaces();
+            case '{':
+                handler_.on_start_object();
+                frames_.push_back(frame{true});
+                state_ = state::object_first;
+                return p + 1;
 
-            if (input_.eat('}')) return result; // empty object_t
+            case 'n':
+            case 't':
+            case 'f':
+                return start_token(token_kind::literal, p);
 
-            ret.reserve(8);
-            while (true)
-            {
-                // read key
-                js_string key;
-                {
-                    if (*input_ == '"') key = std::move(*read_string()->as_string()); // quoted key (normal)
-                    else if (has_option(json_parse_option::allow_unquoted_object_key))
-                    {
-                        while (*input_ != EOF && *input_ > ' ' && *input_ != ':') // until delimiter found
-                            key += static_cast<char_type>(*input_++);             // read a character as  object key
-                    }
-                    else throw bad_format("invalid object format: expected object key", *input_);
-                }
+            case '+':
+            case '-':
+            case '0':
+            case '1':
+            case '2':
+            case '3':
+            case '4':
+            case '5':
+            case '6':
+            case '7':
+            case '8':
+            case '9':
+                return start_token(token_kind::number, p);
 
-                eat_whitespaces();
+            case '"':
+                return start_token(token_kind::string, p);
 
-                if (!input_.eat(':'))
-                    throw bad_format("invalid object format: expected a ':'", *input_);
+            default:
+                throw bad_format("invalid json format: expected an element", std::char_traits<char_type>::to_int_type(*p), p);
+            }
+        }
 
-                eat_whitespaces();
+        // starts an object key at `p`
+        const char_type* start_key(const char_type* p)
+        {
+            if (*p == '"') return start_token(token_kind::quoted_key, p);
+            if (has_option(json_parse_option::allow_unquoted_object_key))
+            {
+                if (*p != ':') return start_token(token_kind::unquoted_key, p);
+                reader_type::notify_key(handler_, {}, offset_of(p)); // empty key (same as json_reader)
+                state_ = state::object_after_key;
+                return p;
+            }
+            throw bad_format("invalid object format: expected object key", std::char_traits<char_type>::to_int_type(*p), p);
+        }
 
-                // read value
-                json value = read_element();
-                ret.insert_or_assign(std::move(key), std::move(value));
+        const char_type* start_token(token_kind kind, const char_type* p)
+        {
+            token_ = kind;
+            token_escape_ = false;
+            token_offset_ = offset_of(p);
+            token_begin_ = p;
+            token_buffer_.clear();
+            return kind == token_kind::string || kind == token_kind::quoted_key ? p + 1 : p; // skips opening quote
+        }
 
-                eat_whitespaces();
+        // reads the token until its end, returns the next of the token or `end`
+        const char_type* read_token(const char_type* p, const char_type* end)
+        {
+            constexpr auto is_number_char = [](char_type c) { return (c >= '0' && c <= '9') || c == '+' || c == '-' || c == '.' || c == 'e' || c == 'E'; };
+            constexpr auto is_literal_char = [](char_type c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); };
+            constexpr auto is_key_char = [](char_type c) { return static_cast<unsigned char>(c) > ' ' && c != ':'; };
 
-                // read ',' or '}'
-                if (input_.eat(','))
+            switch (token_)
+            {
+            case token_kind::string:
+            case token_kind::quoted_key:
+                while (p != end)
                 {
-                    eat_whitespaces();
-
-                    // check '}'
-                    if (input_.eat('}'))
+                    if (token_escape_)
                     {
-                        if (has_option(json_parse_option::allow_trailing_comma)) break; // OK
-                        else throw bad_format("invalid object format: expected an element (trailing comma not allowed)", *input_);
+                        token_escape_ = false;
+                        ++p;
+                        continue;
                     }
 
-                    continue; // to next `key: value`
+                    p = internal::scan::find_string_special(p, end, false);
+                    if (p == end) break;
+                    if (*p == '"') return complete_token(token_begin_, p + 1);
+                    token_escape_ = *p++ == '\\';
                 }
-                else if (input_.eat('}')) break;
-                else throw bad_format("invalid object format: expected ',' or '}'", *input_);
-            }
+                return end;
 
-            return result;
+            case token_kind::number:
+                while (p != end && is_number_char(*p)) ++p;
+                return p != end ? complete_token(token_begin_, p) : end;
+
+            case token_kind::literal:
+                while (p != end && is_literal_char(*p)) ++p;
+                return p != end ? complete_token(token_begin_, p) : end;
+
+            default:
+                while (p != end && is_key_char(*p)) ++p;
+                return p != end ? complete_token(token_begin_, p) : end;
+            }
         }
 
-        // eats BOM sequence `EFBBBF` if allowed.
-        void eat_utf8bom()
+        // decodes the token ends at `end` (in the chunk or the end of token_buffer_) with json_reader, returns `end`
+        const char_type* complete_token(const char_type* begin, const char_type* end)
         {
-            if (input_.eat(0xEF)) // if stream starts with 0xEF, regard it as beginning of UTF-8 BOM.
+            const token_kind kind = std::exchange(token_, token_kind::none);
+            const char_type* source_end = end;
+            if (!token_buffer_.empty() && begin != token_buffer_.data()) // the token spans chunks
             {
-                if (!has_option(json_parse_option::allow_utf8_bom)) throw bad_format("invalid json format: expected an element. (UTF-8 BOM not allowed)", *input_);
-                if (!input_.eat(0xBB)) throw bad_format("invalid json format: UTF-8 BOM sequence expected... 0xBB", *input_);
-                if (!input_.eat(0xBF)) throw bad_format("invalid json format: UTF-8 BOM sequence expected... 0xBF", *input_);
+                token_buffer_.append(begin, end);
+                begin = token_buffer_.data();
+                end = begin + token_buffer_.size();
+            }
+
+            reader_type reader(begin, end, option_bits_);
+            reader.offset_base_ = token_offset_;
+            reader.string_input_buffer_.swap(decode_buffer_);
+            switch (kind)
+            {
+            case token_kind::literal: reader.read_scalar(handler_);
+                break;
+            case token_kind::number: reader.read_number(handler_);
+                break;
+            case token_kind::string: handler_.on_string(reader.read_string());
+                break;
+            case token_kind::quoted_key: reader_type::notify_key(handler_, reader.read_string(), token_offset_);
+                break;
+            default: reader_type::notify_key(handler_, reader.read_unquoted_key(), token_offset_);
+                break;
             }
+            reader.string_input_buffer_.swap(decode_buffer_);
+
+            // the rest of the token (such as `.3` in `1.2.3`) is an error, but ignored after the root element (same as json_reader).
+            if (reader.input_.it_ != end && !frames_.empty())
+                throw reader.bad_format("invalid json format: unexpected character", *reader.input_);
+
+            if (kind == token_kind::quoted_key || kind == token_kind::unquoted_key) state_ = state::object_after_key;
+            else end_element();
+            return source_end;
         }
 
-        // eats continuous white spaces and comments `/*...*/`, `//...\n`
-        void eat_whitespaces()
+        // ends array or object at `p`
+        const char_type* end_container(const char_type* p)
         {
-            // locale-independent is_space
-            constexpr auto is_space = [](int_type i)-> bool { return i == ' ' || i == '\t' || i == '\r' || i == '\n'; };
+            const frame f = frames_.back();
+            frames_.pop_back();
+            if (f.object) handler_.on_end_object(f.count);
+            else handler_.on_end_array(f.count);
+            end_element();
+            return p + 1;
+        }
 
-            while (true)
-            {
-                while (is_space(*input_)) ++input_;
+        // moves to the next of an element
+        void end_element()
+        {
+            if (frames_.empty()) state_ = state::done;
+            else if (frames_.back().count++, frames_.back().object) state_ = state::object_after_element;
+            else state_ = state::array_after_element;
+        }
+    };
 
-                if (has_option(json_parse_option::allow_comment) && input_.eat('/'))
-                {
-                    if (input_.eat('*')) // start of block comment
-                    {
-                        while (*input_ != EOF)
-                        {
-                            if (*input_++ == '*' && input_.eat('/'))
-                                break;
-                        }
-                    }
-                    else if (input_.eat('/')) // start of line comment
-                    {
-                        while (*input_ != EOF)
-                        {
-                            if (*input_++ == '\n')
-                                break;
-                        }
-                    }
+    json_push_parser(json_parse_option) -> json_push_parser<json_document_builder<json>>;
 
-                    continue;
-                }
+    /// json_lines_reader: reads JSON Lines (one json per line) in parallel.
+    class json_lines_reader
+    {
+        json::json_string_view source_{};
+        std::vector<json::json_string_view> records_{}; // non-blank lines
+        bool bom_{};                                    // `source_` starts with UTF-8 BOM (not included in the first record)
 
-                break;
+    public:
+        // splits `source` into lines after UTF-8 BOM if any, skipping blank lines. `source` must outlive the reader.
+        explicit json_lines_reader(json::json_string_view source) : source_(source)
+        {
+            constexpr json::char_type utf8bom[] = { static_cast<json::char_type>(0xEF), static_cast<json::char_type>(0xBB), static_cast<json::char_type>(0xBF) };
+            bom_ = source.size() >= 3 && source.compare(0, 3, json::json_string_view(utf8bom, 3)) == 0;
+
+            const json::char_type* const end = source.data() + source.size();
+            for (const json::char_type* p = source.data() + (bom_ ? 3 : 0); p < end;)
+            {
+                const json::char_type* eol = internal::scan::find(p, end, '\n');
+                if (internal::scan::skip_whitespaces(p, eol) != eol)
+                    records_.emplace_back(p, static_cast<size_t>(eol - p));
+                p = eol + 1;
             }
         }
 
-        // makes a bad_format exception with error message
-        [[nodiscard]] exceptions::bad_format bad_format(std::string_view reason, std::optional<int_type> but_encountered = std::nullopt) const
+        // gets the number of records
+        [[nodiscard]] size_t size() const noexcept { return records_.size(); }
+
+        // parses records on `thread_count` threads (0: the number of hardware threads),
+        // calls `callback(size_t index, json&& value)` for each record in any order, from the worker threads concurrently.
+        // throws bad_format with the line/column if a line is malformed, nested deeper than `max_depth`, or has anything but white spaces after the json.
+        template <class Callback>
+        void read(Callback&& callback, json_parse_option loose = json_parse_option::default_option, size_t thread_count = 0, size_t max_depth = NANOJSON3_MAX_DEPTH) const
         {
-            std::stringstream message;
-            message << "bad_format: ";
-            message << reason;
-            if (but_encountered)
+            if (bom_) json::json_reader<const json::char_type*>(source_.data(), source_.data() + source_.size(), loose).eat_utf8bom(); // throws if not allowed
+
+            constexpr size_t batch_size = 64; // records taken by a worker at once
+            const size_t batch_count = (records_.size() + batch_size - 1) / batch_size;
+
+            std::atomic<size_t> next{0};
+            internal::run_parallel((std::min)(internal::worker_thread_count(thread_count), batch_count), [&](const std::atomic<bool>& cancelled)
             {
-                message << " but encountered ";
-                if (*but_encountered == EOF)
-                {
-                    message << "EOF";
-                }
-                else if (*but_encountered >= 0x20 && but_encountered < 0x7F)
-                {
-                    message << "'";
-                    message << static_cast<char>(*but_encountered);
-                    message << "'";
-                }
-                else
-                {
-                    message << "(char)";
-                    message << std::hex << std::setfill('0') << std::setw(2) << *but_encountered;
-                }
-            }
-            message << " at line ";
-            message << (input_.current_position_line_ + 1);
-            message << " column ";
-            message << (input_.current_position_column_ + 1);
-            message << ".";
+                for (size_t begin; !cancelled && (begin = next.fetch_add(batch_size)) < records_.size();)
+                    for (size_t i = begin, end = (std::min)(begin + batch_size, records_.size()); i < end; i++)
+                        callback(i, read_record(records_[i], loose, max_depth));
+            });
+        }
 
-            return exceptions::bad_format{message.str()};
+    private:
+        // reads `record` with the input starting at the beginning of `source_`, so errors are reported with the position in `source_`.
+        // UTF-8 BOM is not accepted in records (only at the beginning of `source_`, checked by `read`).
+        [[nodiscard]] json read_record(json::json_string_view record, json_parse_option loose, size_t max_depth) const
+        {
+            json_document_builder<json> builder(loose);
+            json::json_reader<const json::char_type*> reader(source_.data(), record.data() + record.size(), loose);
+            reader.input_.it_ = record.data();
+            reader.max_depth_ = max_depth;
+            reader.eat_whitespaces();
+            reader.read_element(builder);
+            reader.eat_whitespaces();
+            if (*reader.input_ != EOF) throw reader.bad_format("invalid json lines format: expected end of line", *reader.input_);
+            return builder.result();
         }
     };
 
@@ -1423,10 +4954,20 @@ namespace nanojson3
 
         const json_serialize_option option_bits_{};
         const json_floating_format_options floating_format_{};
+        const int floating_precision_ = (std::min)(floating_format_.floating_precision, 64);
+        js_floating overflow_limit_{};  // floating values out of (underflow_limit_, overflow_limit_) are written in general format
+        js_floating underflow_limit_{};
         std::basic_string<json::char_type> indent_stack_{};
 
         // ctor
-        json_writer(CharOutputIterator& out, json_serialize_option option, json_floating_format_options format) : output_(out), option_bits_(option), floating_format_(format) {}
+        json_writer(CharOutputIterator& out, json_serialize_option option, json_floating_format_options format) : output_(out), option_bits_(option), floating_format_(format)
+        {
+            if (floating_precision_ >= 0)
+            {
+                overflow_limit_ = std::pow(static_cast<js_floating>(10), floating_precision_);
+                underflow_limit_ = std::pow(static_cast<js_floating>(10), -floating_precision_);
+            }
+        }
 
         // executes serializing
         void execute(const json& value)
@@ -1491,6 +5032,7 @@ namespace nanojson3
             case json_type_index::string: return write_element(*value.value().as_string());
             case json_type_index::array: return write_element(*value.value().as_array());
             case json_type_index::object: return write_element(*value.value().as_object());
+            case json_type_index::raw_number: return write_element(*value.value().as_raw_number());
             }
         }
 
@@ -1527,6 +5069,14 @@ namespace nanojson3
             output_ << integer_to_chars(buf, v);
         }
 
+        // raw number: writes the text as is
+        void write_element(const json::js_raw_number& v)
+        {
+            using namespace std::string_view_literals;
+            if (has_option(json_serialize_option::debug_dump_type_as_comment)) output_ << "/***  RAW NUMBER  ***/ "sv;
+            output_ << js_string_view(v.text());
+        }
+
         // floating
         void write_element(const js_floating v)
         {
@@ -1542,15 +5092,28 @@ namespace nanojson3
             {
                 output_ << (v >= 0 ? "1.0e999999999"sv : "-1.0e999999999"sv);
             }
+            else if (floating_precision_ < 0) // shortest round-trip
+            {
+#if (defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L) // compiler has floating-point to_chars
+                char s[128]{};
+                auto [ptr, ec] = std::to_chars(std::begin(s), std::end(s), v);
+                if (ec != std::errc{}) throw bad_value("failed to to_chars(floating)");
+                output_ << std::string_view(s, static_cast<size_t>(ptr - s));
+#else // use fallback implementation
+                std::ostringstream s{};
+                s.imbue(std::locale::classic());
+                s << std::setprecision(std::numeric_limits<js_floating>::max_digits10);
+                s << v;
+                output_ << s.str();
+#endif
+            }
             else // normal
             {
                 std::chars_format format = std::chars_format::general;
-                const auto precision = std::clamp(floating_format_.floating_precision, 0, 64);
-                const auto overflow_limit = std::pow(static_cast<json::js_floating>(10), precision);
-                const auto underflow_limit = std::pow(static_cast<json::js_floating>(10), -precision);
+                const auto precision = floating_precision_;
 
                 if (const auto abs = std::abs(v);
-                    abs < overflow_limit && abs > underflow_limit)
+                    abs < overflow_limit_ && abs > underflow_limit_)
                     format = floating_format_.floating_format;
 
 #if (defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L) // compiler has floating-point to_chars
@@ -1664,17 +5227,178 @@ namespace nanojson3
 
     inline namespace io
     {
-        // json from CharInputIterator pair
+        // json from CharInputIterator pair. arrays and objects nested deeper than `max_depth` are rejected with bad_format.
         template <class CharInputIterator>
-        static json parse_json(CharInputIterator begin, CharInputIterator end, json_parse_option loose = json_parse_option::default_option)
+        static json parse_json(CharInputIterator begin, CharInputIterator end, json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            return json::json_reader<CharInputIterator>::read_json(std::move(begin), std::move(end), loose, max_depth);
+        }
+
+        // json from string_view. arrays and objects nested deeper than `max_depth` are rejected with bad_format.
+        static json parse_json(json::json_string_view sv, json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            return io::parse_json<const json::char_type*>(sv.data(), sv.data() + sv.size(), loose, max_depth);
+        }
+
+        // reads json from CharInputIterator pair and notifies elements to `handler` (see `json_event_handler`), without making json values.
+        // arrays and objects nested deeper than `max_depth` are rejected with bad_format.
+        template <class CharInputIterator, class Handler>
+        static void parse_json_events(CharInputIterator begin, CharInputIterator end, Handler& handler, json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            json::json_reader<CharInputIterator>::read_json(std::move(begin), std::move(end), loose, handler, max_depth);
+        }
+
+        // reads json from string_view and notifies elements to `handler` (see `json_event_handler`), without making json values.
+        template <class Handler>
+        static void parse_json_events(json::json_string_view sv, Handler& handler, json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            io::parse_json_events<const json::char_type*>(sv.data(), sv.data() + sv.size(), handler, loose, max_depth);
+        }
+
+        // json_view from mutable buffer `[buffer, buffer + length)`.
+        // escape sequences in strings are decoded in place, and strings in the result refer to the buffer. The buffer must outlive the result.
+        inline json_view parse_in_situ(json::char_type* buffer, size_t length, json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            json_document_builder<json_view> builder(loose);
+            json::json_reader<json::char_type*>::read_json_in_situ(buffer, buffer + length, loose, builder, max_depth);
+            return builder.result();
+        }
+
+        // json from string_view, read in two stages with structural index. (faster on large input)
+        // produces the same result as `parse_json`, falling back to it
+        // if `loose` needs byte-by-byte reading (`allow_comment`, `allow_unquoted_object_key`), or to report the precise error on malformed input.
+        inline json parse_json_indexed(json::json_string_view sv, json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            try
+            {
+                json_document_builder<json> builder(loose);
+                if (json::json_reader<const json::char_type*>::read_json_indexed(sv.data(), sv.data() + sv.size(), loose, builder, max_depth))
+                    return builder.result();
+            }
+            catch (const bad_format&)
+            {
+                // falls through to reread
+            }
+            return parse_json(sv, loose, max_depth);
+        }
+
+        // json from string_view whose root is a large array: finds the elements of the root array first, then reads them on `thread_count` threads
+        // (0: the number of hardware threads). produces the same result as `parse_json`, falling back to it
+        // if the root is not an array, `loose` needs byte-by-byte reading (`allow_comment`, `allow_unquoted_object_key`), or to report the precise error on malformed input.
+        inline json parse_json_parallel(json::json_string_view sv, json_parse_option loose = json_parse_option::default_option, size_t thread_count = 0, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            try
+            {
+                if (auto result = json::json_reader<const json::char_type*>::read_json_parallel(sv.data(), sv.data() + sv.size(), loose, thread_count, max_depth))
+                    return std::move(*result);
+            }
+            catch (const bad_format&)
+            {
+                // falls through to reread
+            }
+            return parse_json(sv, loose, max_depth);
+        }
+
+        // reads JSON Lines (one json per line, blank lines are skipped) on `thread_count` threads (0: the number of hardware threads),
+        // calls `callback(size_t index, json&& value)` for each record in any order, from the worker threads concurrently.
+        // throws bad_format with the line/column if a line is malformed, nested deeper than `max_depth`, or has anything but white spaces after the json.
+        template <class Callback>
+        static void for_each_json_line(json::json_string_view source, Callback&& callback, json_parse_option loose = json_parse_option::default_option, size_t thread_count = 0, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            json_lines_reader(source).read(callback, loose, thread_count, max_depth);
+        }
+
+        // reads JSON Lines (one json per line, blank lines are skipped) on `thread_count` threads (0: the number of hardware threads),
+        // returns the records in input order. throws bad_format with the line/column if a line is malformed, nested deeper than `max_depth`, or has anything but white spaces after the json.
+        inline std::vector<json> parse_json_lines(json::json_string_view source, json_parse_option loose = json_parse_option::default_option, size_t thread_count = 0, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            json_lines_reader reader(source);
+            std::vector<json> result(reader.size());
+            reader.read([&](size_t index, json&& value) { result[index] = std::move(value); }, loose, thread_count, max_depth);
+            return result;
+        }
+
+        // json_view_document from string_view.
+        // strings without escape sequences refer to `source`, so `source` must outlive the result.
+        inline json_view_document parse_json_view(json::json_string_view source, json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            json_view_document document{};
+            json_document_builder<json_view> builder(source, &document.storage(), loose);
+            json::json_reader<const json::char_type*>::read_json(source.data(), source.data() + source.size(), loose, builder, max_depth);
+            document.set_root(builder.result());
+            return document;
+        }
+
+        // json_view_document owning copies of all strings, so `source` may be discarded after parsing.
+        // object keys are interned: equal keys (e.g. in an array of records) share one copy in the document's storage.
+        inline json_view_document parse_json_document(json::json_string_view source, json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            json_view_document document{};
+            json_document_builder<json_view> builder(&document.storage(), loose);
+            json::json_reader<const json::char_type*>::read_json(source.data(), source.data() + source.size(), loose, builder, max_depth);
+            document.set_root(builder.result());
+            return document;
+        }
+
+        // json_tape_document from string_view
+        inline json_tape_document parse_json_tape(json::json_string_view sv, json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            json_tape_builder builder{};
+            json::json_reader<const json::char_type*>::read_json(sv.data(), sv.data() + sv.size(), loose, builder, max_depth);
+            return builder.result();
+        }
+
+        // json_lazy_document from string_view, reading arrays and objects on first access (see `json_lazy_view`).
+        // `source` must outlive the result.
+        inline json_lazy_document parse_json_lazy(json::json_string_view source, json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            return json_lazy_document(source, loose, max_depth);
+        }
+
+        // json from the file at `path`, mapped into memory if possible (see `json_mapped_file`). throws std::system_error if the file can't be read.
+        inline json parse_json_file(const std::string& path, json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            const json_mapped_file file(path);
+            return io::parse_json(file.view(), loose, max_depth);
+        }
+
+        // json_view_document owning copies of all strings, from the file at `path` (see `parse_json_file`, `parse_json_document`).
+        inline json_view_document parse_json_document_file(const std::string& path, json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH)
         {
-            return json::json_reader<CharInputIterator>::read_json(std::move(begin), std::move(end), loose);
+            const json_mapped_file file(path);
+            return io::parse_json_document(file.view(), loose, max_depth);
         }
 
-        // json from string_view
-        static json parse_json(json::json_string_view sv, json_parse_option loose = json_parse_option::default_option)
+        // json_lazy_document owning the mapping of the file at `path` (see `parse_json_file`, `parse_json_lazy`).
+        inline json_lazy_document parse_json_lazy_file(const std::string& path, json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH)
         {
-            return io::parse_json<json::json_string_view::const_iterator>(sv.begin(), sv.end(), loose);
+            return json_lazy_document(json_mapped_file(path), loose, max_depth);
+        }
+
+        // json from string_view, making only the elements selected by `filter` and their ancestors (see `json_path_filter`).
+        inline json parse_json_paths(json::json_string_view sv, const json_path_filter& filter, json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            json_cursor cursor(sv, loose, max_depth);
+            return filter.read(cursor);
+        }
+
+        // reads `target` from string_view directly with `json_deserializer<T>` (such as structs having `json_fields`, containers and scalars),
+        // without making json values. throws bad_access if the json doesn't match the type, and bad_format if nested deeper than `max_depth`.
+        template <class T>
+        inline void parse_into(json::json_string_view sv, T& target, json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            json_cursor cursor(sv, loose, max_depth);
+            (void)cursor.next_token();
+            json_deserializer<T>::deserialize(cursor, target);
+        }
+
+        // reads `T` from string_view directly (see above)
+        template <class T>
+        [[nodiscard]] inline T parse_into(json::json_string_view sv, json_parse_option loose = json_parse_option::default_option, size_t max_depth = NANOJSON3_MAX_DEPTH)
+        {
+            T value{};
+            io::parse_into(sv, value, loose, max_depth);
+            return value;
         }
 
         // json to string_view
@@ -1696,6 +5420,26 @@ namespace nanojson3
 
     inline json json::parse(const json_string_view& source, json_parse_option opt) { return io::parse_json(source, opt); }
 
+    inline json json::parse_number(const json_string_view& text) noexcept
+    {
+        struct number_handler
+        {
+            json value{};
+            void on_integer(js_integer v) { value = json(in_place_index::integer, v); }
+            void on_floating(js_floating v) { value = json(in_place_index::floating, v); }
+        } handler{};
+
+        try
+        {
+            json_reader<const char_type*>::read_json_number(text.data(), text.data() + text.size(), handler);
+            return handler.value;
+        }
+        catch (const bad_format&)
+        {
+            return js_undefined{};
+        }
+    }
+
     inline json::json_string json::serialize(json_serialize_option opt, json_floating_format_options format) const { return io::serialize_json(*this, opt, format); }
 
     // i/o stream operators
@@ -1745,7 +5489,9 @@ namespace nanojson3
         static inline auto operator >>(std::basic_istream<json::char_type>& istream, json& j) -> decltype(istream)
         {
             const auto opt = static_cast<json_parse_option>(istream.iword(json_istream_parse_option_index()));
-            j = io::parse_json<std::istreambuf_iterator<json::char_type>>(istream, {}, opt);
+            internal::streambuf_reader<json::char_type, json::char_traits> reader(istream.rdbuf());
+            j = io::parse_json(reader.begin(), reader.end(), opt);
+            if (!reader.release()) istream.setstate(std::ios_base::badbit);
             return istream;
         }
 
@@ -1772,7 +5518,9 @@ namespace nanojson3
             // opt
             const auto opt = static_cast<json_serialize_option>(ostream.iword(json_ostream_serialize_option_index()));
             const auto fmt = json_floating_format_options_from_stream(ostream);
-            io::serialize_json<std::ostreambuf_iterator<json::char_type>>(ostream, j, opt, fmt);
+            internal::streambuf_writer<json::char_type, json::char_traits> writer(ostream.rdbuf());
+            io::serialize_json(writer.begin(), j, opt, fmt);
+            if (!writer.flush()) ostream.setstate(std::ios_base::badbit);
             return ostream;
         }
     }
@@ -1905,12 +5653,279 @@ namespace nanojson3
     {
         template <class U> static json serialize(U&& val) { return to_json(std::forward<U>(val)); }
     };
+
+    // json_deserializer specializations
+
+    namespace json_deserializer_helper
+    {
+        // gets the length and the first and last characters of `key` in one word, to reject most of mismatching keys with one comparison.
+        [[nodiscard]] constexpr uint64_t key_signature(json::js_string_view key) noexcept
+        {
+            return key.empty() ? 0 : static_cast<uint64_t>(key.size()) << 16 | static_cast<uint64_t>(static_cast<unsigned char>(key.front())) << 8 | static_cast<unsigned char>(key.back());
+        }
+
+        // a field of `json_fields` identified by its signature, sorted at compile time (see `sort_fields`)
+        struct field_entry
+        {
+            uint64_t signature;
+            json::js_string_view name;
+            size_t index; // in `json_fields`
+        };
+
+        // sorts `entries` by signature, i.e. by length, then by the first and last characters of the names.
+        template <size_t N>
+        [[nodiscard]] constexpr std::array<field_entry, N> sort_fields(std::array<field_entry, N> entries) noexcept
+        {
+            for (size_t i = 1; i < N; i++)
+            {
+                const field_entry e = entries[i];
+                size_t j = i;
+                for (; j > 0 && entries[j - 1].signature > e.signature; j--) entries[j] = entries[j - 1];
+                entries[j] = e;
+            }
+            return entries;
+        }
+
+        // gets the fields of `T::json_fields` sorted by signature
+        template <class T, size_t... I>
+        [[nodiscard]] constexpr std::array<field_entry, sizeof...(I)> make_sorted_fields(std::index_sequence<I...>) noexcept
+        {
+            return sort_fields(std::array<field_entry, sizeof...(I)>{ field_entry{ std::get<I>(T::json_fields).signature, std::get<I>(T::json_fields).name, I }... });
+        }
+
+        // gets the index of the first field of `T::json_fields` bound to the same data member as the `I`-th field (aliases share it)
+        template <class T, size_t I, size_t... J>
+        [[nodiscard]] constexpr size_t first_field_of_member(std::index_sequence<J...>) noexcept
+        {
+            size_t index = sizeof...(J);
+            ([&]
+            {
+                const auto& a = std::get<I>(T::json_fields);
+                const auto& b = std::get<J>(T::json_fields);
+                if constexpr (std::is_same_v<decltype(a.member), decltype(b.member)>)
+                    if (index == sizeof...(J) && a.member == b.member) index = J;
+            }(), ...);
+            return index;
+        }
+
+        template <class T, size_t... I>
+        [[nodiscard]] constexpr std::array<size_t, sizeof...(I)> make_member_slots(std::index_sequence<I...>) noexcept
+        {
+            return { first_field_of_member<T, I>(std::index_sequence<I...>{})... };
+        }
+
+        // throws bad_access if the current token of `cursor` is not `token`
+        template <class Cursor>
+        void expect_token(const Cursor& cursor, json_token token)
+        {
+            if (cursor.token() != token) throw bad_access();
+        }
+
+        // type_traits
+
+        template <class Container, class = void>
+        struct is_sequence_container : std::false_type {};
+
+        template <class Container>
+        struct is_sequence_container<Container, std::void_t<typename Container::value_type, decltype(std::declval<Container&>().emplace_back()), decltype(std::declval<Container&>().clear())>>
+            : std::bool_constant<!std::is_same_v<typename Container::value_type, json::char_type>> {};
+
+        template <class Container, class = void>
+        struct is_map_container : std::false_type {};
+
+        template <class Container>
+        struct is_map_container<Container, std::void_t<typename Container::mapped_type, decltype(std::declval<Container&>()[std::declval<typename Container::key_type>()]), decltype(std::declval<Container&>().clear())>>
+            : std::is_constructible<typename Container::key_type, json::js_string_view> {};
+    }
+
+    /// json_field: binds an object member named `name` to the data member `member` of `T`.
+    /// `json_deserializer` reads `T` from an object if `T` has `static constexpr auto json_fields = std::make_tuple(json_field(...), ...);`.
+    /// Members missing from the object are reset to those of `T{}`, so reading into a reused `T` gives the same result as reading into a new one.
+    /// A member given twice (by its name or an alias) is treated as the duplicate key options of `json_parse_option` specify.
+    /// Members are looked up by binary search over the fields sorted by their name's length and first/last characters at compile time, and unknown members are skipped.
+    template <class T, class M>
+    struct json_field
+    {
+        json::js_string_view name;
+        M T::* member;
+        uint64_t signature;
+
+        constexpr json_field(json::js_string_view name, M T::* member) noexcept : name(name), member(member), signature(json_deserializer_helper::key_signature(name)) { }
+    };
+
+    // read `json` (a whole value)
+    template <>
+    struct json_deserializer<json>
+    {
+        template <class Cursor> static void deserialize(Cursor& cursor, json& value) { value = cursor.get_json(); }
+    };
+
+    // read `bool` from boolean
+    template <>
+    struct json_deserializer<bool>
+    {
+        template <class Cursor> static void deserialize(Cursor& cursor, bool& value) { value = cursor.get_boolean(); }
+    };
+
+    // read integral types (except `bool` and `char`) from integer, throwing bad_access if out of range
+    template <class T>
+    struct json_deserializer<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, json::char_type>>>
+    {
+        template <class Cursor> static void deserialize(Cursor& cursor, T& value)
+        {
+            const json::js_integer v = cursor.get_integer();
+            if constexpr (std::is_signed_v<T>)
+            {
+                if (v < (std::numeric_limits<T>::min)() || v > (std::numeric_limits<T>::max)()) throw bad_access("bad_access: integer out of range");
+            }
+            else
+            {
+                if (v < 0 || static_cast<std::make_unsigned_t<json::js_integer>>(v) > (std::numeric_limits<T>::max)()) throw bad_access("bad_access: integer out of range");
+            }
+            value = static_cast<T>(v);
+        }
+    };
+
+    // read floating point types from integer or floating
+    template <class T>
+    struct json_deserializer<T, std::enable_if_t<std::is_floating_point_v<T>>>
+    {
+        template <class Cursor> static void deserialize(Cursor& cursor, T& value) { value = static_cast<T>(cursor.get_number()); }
+    };
+
+    // read `basic_string<char>` from string
+    template <class Traits, class Allocator>
+    struct json_deserializer<std::basic_string<json::char_type, Traits, Allocator>>
+    {
+        template <class Cursor> static void deserialize(Cursor& cursor, std::basic_string<json::char_type, Traits, Allocator>& value)
+        {
+            const json::js_string_view s = cursor.get_string();
+            value.assign(s.data(), s.size());
+        }
+    };
+
+    // read `optional<T>` from null, or as `T`
+    template <class T>
+    struct json_deserializer<std::optional<T>>
+    {
+        template <class Cursor> static void deserialize(Cursor& cursor, std::optional<T>& value)
+        {
+            if (cursor.token() == json_token::null) return value.reset();
+            if (!value) value.emplace();
+            json_deserializer<T>::deserialize(cursor, *value);
+        }
+    };
+
+    // read `container<T>` (having `emplace_back()`) from array, reusing its capacity
+    template <class Container>
+    struct json_deserializer<Container, std::enable_if_t<json_deserializer_helper::is_sequence_container<Container>::value>>
+    {
+        template <class Cursor> static void deserialize(Cursor& cursor, Container& value)
+        {
+            json_deserializer_helper::expect_token(cursor, json_token::start_array);
+            value.clear();
+            while (cursor.next_token() != json_token::end_array)
+                json_deserializer<typename Container::value_type>::deserialize(cursor, value.emplace_back());
+        }
+    };
+
+    // read `map<K, V>` (K is constructible from string) from object, treating duplicate keys as `json_parse_option` specifies
+    template <class Container>
+    struct json_deserializer<Container, std::enable_if_t<json_deserializer_helper::is_map_container<Container>::value>>
+    {
+        template <class Cursor> static void deserialize(Cursor& cursor, Container& value)
+        {
+            json_deserializer_helper::expect_token(cursor, json_token::start_object);
+            value.clear();
+            while (cursor.next_token() == json_token::key)
+            {
+                const size_t size = value.size();
+                auto& v = value[typename Container::key_type(cursor.get_string())];
+                if (value.size() == size && !cursor.accepts_duplicate_key()) { cursor.skip_value(); continue; }
+                (void)cursor.next_token();
+                json_deserializer<typename Container::mapped_type>::deserialize(cursor, v);
+            }
+        }
+    };
+
+    // read `T` from object if `T` has `json_fields` (see `json_field`)
+    template <class T>
+    struct json_deserializer<T, std::void_t<decltype(T::json_fields)>>
+    {
+        template <class Cursor> static void deserialize(Cursor& cursor, T& value)
+        {
+            json_deserializer_helper::expect_token(cursor, json_token::start_object);
+            std::array<bool, field_count> read{};
+            while (cursor.next_token() == json_token::key)
+            {
+                const size_t index = find_field(cursor.get_string());
+                if (index == field_count || (read[member_slots[index]] && !cursor.accepts_duplicate_key())) cursor.skip_value();
+                else read_field(cursor, value, index, std::make_index_sequence<field_count>{}), read[member_slots[index]] = true;
+            }
+            reset_unread_fields(value, read, std::make_index_sequence<field_count>{});
+        }
+
+    private:
+        static constexpr size_t field_count = std::tuple_size_v<std::remove_cv_t<decltype(T::json_fields)>>;
+        static constexpr auto sorted_fields = json_deserializer_helper::make_sorted_fields<T>(std::make_index_sequence<field_count>{});
+        static constexpr auto member_slots = json_deserializer_helper::make_member_slots<T>(std::make_index_sequence<field_count>{});
+
+        // gets the index of the field named `key` in `json_fields`, or `field_count` if not found
+        [[nodiscard]] static size_t find_field(json::js_string_view key) noexcept
+        {
+            const uint64_t signature = json_deserializer_helper::key_signature(key);
+            auto it = std::lower_bound(sorted_fields.begin(), sorted_fields.end(), signature, [](const json_deserializer_helper::field_entry& e, uint64_t s) { return e.signature < s; });
+            for (; it != sorted_fields.end() && it->signature == signature; ++it)
+                if (key.compare(it->name) == 0) return it->index;
+            return field_count;
+        }
+
+        // reads the value into the `index`-th field of `value`, through a jump table
+        template <class Cursor, size_t... I>
+        static void read_field(Cursor& cursor, T& value, size_t index, std::index_sequence<I...>)
+        {
+            static constexpr std::array<void (*)(Cursor&, T&), field_count> readers{ &read_field_at<Cursor, I>... };
+            (void)cursor.next_token();
+            readers[index](cursor, value);
+        }
+
+        template <class Cursor, size_t I>
+        static void read_field_at(Cursor& cursor, T& value)
+        {
+            const auto& field = std::get<I>(T::json_fields);
+            json_deserializer<std::remove_reference_t<decltype(value.*field.member)>>::deserialize(cursor, value.*field.member);
+        }
+
+        // resets the fields missing from the object (and not read through an alias) to those of `T{}`, as containers are cleared before reading.
+        // (assigning keeps the capacity of strings and containers)
+        template <size_t... I>
+        static void reset_unread_fields(T& value, const std::array<bool, field_count>& read, std::index_sequence<I...>)
+        {
+            if ((read[member_slots[I]] && ...)) return;
+            [[maybe_unused]] static const T defaults{};
+            ((read[member_slots[I]] ? void() : void(value.*std::get<I>(T::json_fields).member = defaults.*std::get<I>(T::json_fields).member)), ...);
+        }
+    };
 }
 
 // utilized namespace
 namespace njs3
 {
     using json = nanojson3::json;
+    using json_view = nanojson3::json_view;
+    using json_view_document = nanojson3::json_view_document;
+    using json_tape_view = nanojson3::json_tape_view;
+    using json_tape_document = nanojson3::json_tape_document;
+    using json_lazy_view = nanojson3::json_lazy_view;
+    using json_lazy_document = nanojson3::json_lazy_document;
+    using json_mapped_file = nanojson3::json_mapped_file;
+    using json_event_handler = nanojson3::json_event_handler;
+    using json_token = nanojson3::json_token;
+    using nanojson3::json_cursor;
+    using nanojson3::json_path_filter;
+    using nanojson3::json_push_parser;
+    using nanojson3::json_parser;
+    using json_lines_reader = nanojson3::json_lines_reader;
     using json_string = nanojson3::json::json_string;
 
     using js_undefined = nanojson3::json::js_undefined;
@@ -1925,6 +5940,7 @@ namespace njs3
     using js_object_key = nanojson3::json::js_object_key;
     using js_object_kvp = nanojson3::json::js_object_kvp;
     using js_object = nanojson3::json::js_object;
+    using js_raw_number = nanojson3::json::js_raw_number;
 
     using json_string_view = nanojson3::json::json_string_view;
     using js_string_view = nanojson3::json::js_string_view;
@@ -1940,6 +5956,21 @@ namespace njs3
     using json_serialize_option = nanojson3::json_serialize_option;
     using json_floating_format_options = nanojson3::json_floating_format_options;
     using nanojson3::io::parse_json;
+    using nanojson3::io::parse_json_events;
+    using nanojson3::io::parse_in_situ;
+    using nanojson3::io::parse_json_view;
+    using nanojson3::io::parse_json_document;
+    using nanojson3::io::parse_json_indexed;
+    using nanojson3::io::parse_json_parallel;
+    using nanojson3::io::parse_json_tape;
+    using nanojson3::io::parse_json_paths;
+    using nanojson3::io::parse_json_lazy;
+    using nanojson3::io::parse_json_file;
+    using nanojson3::io::parse_json_document_file;
+    using nanojson3::io::parse_json_lazy_file;
+    using nanojson3::io::parse_into;
+    using nanojson3::io::parse_json_lines;
+    using nanojson3::io::for_each_json_line;
     using nanojson3::io::serialize_json;
 
     inline namespace ios
@@ -1954,5 +5985,7 @@ namespace njs3
     }
 
     using nanojson3::json_serializer;
+    using nanojson3::json_deserializer;
+    using nanojson3::json_field;
 }
 #endif
@@ -15,6 +15,7 @@
 #include <tuple>
 #include <map>
 #include <vector>
+#include <optional>
 
 #define DEBUG_OUTPUT(...) (#__VA_ARGS__) << " => " << (__VA_ARGS__) << "\n"
 
@@ -70,7 +71,7 @@ void sample_code_snippets()
             | njs3::json_parse_option::allow_trailing_comma      // allows comma following last element
             | njs3::json_parse_option::allow_unquoted_object_key // allows naked object key
             // or simply ` njs3::json_parse_option::all` enables all loose option flags.
-        );
+        ) << std::endl;
 
         //  makes 👇 output.json is
         //  {
@@ -88,6 +89,31 @@ void sample_code_snippets()
         //    "naked_key": "hello world"
         //  }
     }
+    {
+        //  👇 The reader does not recurse on the native stack. Arrays and objects nested deeper than `max_depth` (default `NANOJSON3_MAX_DEPTH`, 1024) are rejected with `bad_format`.
+        try { njs3::parse_json("[[[[[[[[[[1]]]]]]]]]]", njs3::json_parse_option::default_option, 8); }
+        catch (const njs3::bad_format& e) { std::cout << e.what() << std::endl; } // too deeply nested (max depth 8)
+    }
+    {
+        //  👇 Members are appended without lookup, and duplicate keys are resolved per object afterwards (with a hash table for large objects). By default the last value wins; flags select the first value or rejection.
+        auto src = R"({"a": 1, "b": 2, "a": 3})";
+        std::cout << njs3::parse_json(src).serialize() << std::endl;                                                    // {"a":3,"b":2}
+        std::cout << njs3::parse_json(src, njs3::json_parse_option::keep_first_duplicate_key).serialize() << std::endl; // {"a":1,"b":2}
+        try { njs3::parse_json(src, njs3::json_parse_option::reject_duplicate_key); }
+        catch (const njs3::bad_format& e) { std::cout << e.what() << std::endl; }                                       // duplicate key "a" at offset 17
+    }
+    {
+        //  👇 With `raw_number`, numbers are kept as their source text (`js_raw_number`), converted only when `get_integer()`, `get_floating()`, `get_number()`... read them, and written as is.
+        auto src = R"({"id": 12345678901234567890123, "price": 0.10, "count": 3})";
+        njs3::json json = njs3::parse_json(src, njs3::json_parse_option::raw_number);
+        std::cout << json["count"].get_integer() << std::endl; // 3
+        std::cout << json.serialize() << std::endl;            // {"id":12345678901234567890123,"price":0.10,"count":3}
+    }
+    {
+        //  👇 With `validate_utf8`, strings and object keys must be valid UTF-8. The check is fused into the string scanning, so ASCII text costs almost nothing extra.
+        try { njs3::parse_json("[\"caf\xC3\"]", njs3::json_parse_option::default_option | njs3::json_parse_option::validate_utf8); }
+        catch (const njs3::bad_format& e) { std::cout << e.what() << std::endl; } // invalid UTF-8 sequence
+    }
 
     // ### 🌟 Basic Read/Write Access To Json Object
     {
@@ -209,6 +235,128 @@ void sample_code_snippets()
         std::cout << njs3::json_out_pretty << json << std::endl;
     }
 
+    //  ### 🌟 Parsing In-Situ Into `json_view`
+    {
+        //  👇 If the input buffer is mutable and outlives the result, `parse_in_situ` decodes strings in place and makes `json_view` without allocating strings.
+        std::string buffer = R"({"name": "nanojson", "tags": ["json", "c++17"]})";
+        njs3::json_view view = njs3::parse_in_situ(buffer.data(), buffer.size()); // `buffer` is modified.
+        std::cout << DEBUG_OUTPUT(view["name"].get_string());            // std::string_view refers to `buffer`
+        std::cout << DEBUG_OUTPUT(view["tags"][1].get_string_or("none")); // "c++17"
+        njs3::json json = view;                                            // makes a copy owning its strings.
+        std::cout << njs3::json_out_pretty << json << std::endl;
+
+        //  👇 If the input is read-only, `parse_json_view` leaves it untouched. Only strings with escape sequences are copied into the document.
+        std::string_view source = R"({"name": "nano\u006Ason", "version": 3})";
+        njs3::json_view_document document = njs3::parse_json_view(source); // `source` must outlive `document`.
+        std::cout << DEBUG_OUTPUT(document["name"].get_string());           // "nanojson": decoded into the document
+        std::cout << DEBUG_OUTPUT(document["version"].get_integer());       // 3
+
+        //  👇 `parse_json_document` copies all strings into the document, so the source may be discarded. Equal object keys (e.g. in an array of records) share one copy. `parse_json_tape` interns object keys likewise.
+        njs3::json_view_document records = njs3::parse_json_document(R"([{"id": 1}, {"id": 2}])");
+        std::cout << DEBUG_OUTPUT(records[0].as_object()->begin()->first.data() == records[1].as_object()->begin()->first.data()); // true
+
+        //  👇 `parse_json_tape` stores the whole document in two flat buffers. `json_tape_view` jumps over subtrees to find elements.
+        njs3::json_tape_document tape = njs3::parse_json_tape(R"({"name": "nanojson", "tags": ["json", "c++17"]})");
+        std::cout << DEBUG_OUTPUT(tape["tags"].size());                    // 2
+        std::cout << DEBUG_OUTPUT(tape["tags"][1].get_string_or("none"));  // "c++17"
+        for (auto it = tape.root().begin(); it != tape.root().end(); ++it)
+            std::cout << it.key() << ": " << (*it).to_json() << std::endl; // members of the root object
+    }
+
+    //  ### 🌟 Reading Events Without Making Values
+    {
+        //  👇 `parse_json_events` notifies each element to a handler instead of building a `json` tree.
+        struct score_summary : njs3::json_event_handler // defines only needed events
+        {
+            bool in_score = false;
+            double total = 0;
+            void on_key(std::string_view key) { in_score = key == "score"; }
+            void on_integer(njs3::js_integer value) { on_floating(static_cast<njs3::js_floating>(value)); }
+            void on_floating(njs3::js_floating value) { if (in_score) total += static_cast<double>(value); }
+        };
+
+        score_summary summary{};
+        njs3::parse_json_events(R"([{"name": "a", "score": 12}, {"name": "b", "score": 30.5}])", summary);
+        std::cout << DEBUG_OUTPUT(summary.total); // 42.5
+    }
+
+    //  ### 🌟 Pulling Tokens With `json_cursor`
+    {
+        //  👇 `json_cursor` reads one token at a time. Skipped values are only tokenized, not stored.
+        njs3::json_cursor cursor(R"({"id": 42, "payload": {"large": [1, 2, 3]}, "name": "nanojson"})");
+        njs3::js_integer id{};
+        njs3::js_string name{};
+        cursor.next_token(); // start_object
+        while (cursor.next_token() == njs3::json_token::key)
+        {
+            if (cursor.get_string() == "id") id = cursor.read_integer();
+            else if (cursor.get_string() == "name") name = cursor.read_string();
+            else cursor.skip_value(); // skips whole `payload`
+        }
+        std::cout << DEBUG_OUTPUT(id);   // 42
+        std::cout << DEBUG_OUTPUT(name); // "nanojson"
+    }
+
+    //  ### 🌟 Reading Selected Paths Only
+    {
+        //  👇 `parse_json_paths` makes only the elements at the given JSON Pointers (and their ancestors). Other arrays and objects are skipped by quote-aware bracket scan, without validation. Skipped array elements before a selected one are null.
+        auto src = R"({"route": {"service": "billing", "region": "eu"}, "payload": {"items": [1, 2, 3]}, "trace": ["a", "b"]})";
+        const njs3::json json = njs3::parse_json_paths(src, {"/route/service", "/trace/1"});
+        std::cout << DEBUG_OUTPUT(json["route"]["service"].get_string()); // "billing"
+        std::cout << DEBUG_OUTPUT(json["trace"][1].get_string());         // "b"
+        std::cout << DEBUG_OUTPUT(json["payload"].is_undefined());         // true
+        std::cout << json.serialize() << std::endl;                       // {"route":{"service":"billing"},"trace":[null,"b"]} (skipped elements are null)
+    }
+
+    //  ### 🌟 Reading Only Accessed Branches With `parse_json_lazy`
+    {
+        //  👇 `parse_json_lazy` holds arrays and objects as source text until their children are first accessed. Malformed text is reported when the enclosing array or object is read.
+        auto src = R"({"header": {"type": "order", "id": 7}, "lines": [{"sku": "A-1", "qty": 2}, {"sku": "B-2", "qty": 1}], "audit": [[1, 2], [3, 4]]})";
+        const njs3::json_lazy_document doc = njs3::parse_json_lazy(src);
+        std::cout << DEBUG_OUTPUT(doc["header"]["type"].get_string()); // "order"
+        std::cout << DEBUG_OUTPUT(doc["lines"][1]["qty"].get_integer()); // 1
+        std::cout << DEBUG_OUTPUT(doc["audit"].is_array());              // true ("audit" is not read)
+    }
+
+    //  ### 🌟 Feeding Chunks To `json_push_parser`
+    {
+        //  👇 `json_push_parser` reads the source text chunk by chunk. It can suspend anywhere, even in a string or a number.
+        njs3::json_push_parser parser{};
+        parser.feed(R"({"message": "Hel)");
+        parser.feed(R"(lo", "count": 1)");
+        parser.feed(R"(23})");
+        parser.finish();
+        njs3::json json = parser.result();
+        std::cout << DEBUG_OUTPUT(json["message"].get_string()); // "Hello"
+        std::cout << DEBUG_OUTPUT(json["count"].get_integer());  // 123
+    }
+
+    //  ### 🌟 Reusing `json_parser` For Many Small Documents
+    {
+        //  👇 `json_parser` keeps its buffers between documents, and `parse_into` reuses the arrays and objects of the target. (Use one parser per thread.)
+        njs3::json_parser parser{};
+        njs3::json message{};
+        for (auto src : {R"({"id": 1, "tags": ["a"]})", R"({"id": 2, "tags": ["b", "c"]})"})
+        {
+            parser.parse_into(src, message);
+            std::cout << DEBUG_OUTPUT(message["tags"].as_array()->size()); // 1, 2
+        }
+    }
+
+    //  ### 🌟 Reading JSON Lines In Parallel
+    {
+        //  👇 `parse_json_lines` parses each line on worker threads and returns the records in input order. (Link with `Threads::Threads` or `-pthread`.)
+        std::vector<njs3::json> records = njs3::parse_json_lines("{\"id\": 1}\n{\"id\": 2}\n\n{\"id\": 3}\n");
+        std::cout << DEBUG_OUTPUT(records.size());                // 3: blank lines are skipped
+        std::cout << DEBUG_OUTPUT(records[2]["id"].get_integer()); // 3
+    }
+    {
+        //  👇 `parse_json_parallel` finds the elements of a large root array first, then parses them on worker threads. The result is the same as `parse_json`.
+        njs3::json records = njs3::parse_json_parallel(R"([{"id": 1}, {"id": 2}, {"id": 3}])");
+        std::cout << DEBUG_OUTPUT(records.as_array()->size());     // 3
+        std::cout << DEBUG_OUTPUT(records[1]["id"].get_integer()); // 2
+    }
+
     //  ### 🌟 Making JSON Values From Scratch
     {
         // Makes array from values
@@ -333,6 +481,9 @@ void sample_code_snippets()
     //  😕.o( if a user-defined type is in another library and it cannot be changed, what should I do? )
     extern void fixed_user_defined_types();
     fixed_user_defined_types();
+
+    extern void reading_user_defined_types();
+    reading_user_defined_types();
 }
 
 //  ### 🌟 Adding User-defined JSON Serializer (User-defined JSON Constructor Plug-in system)
@@ -424,6 +575,57 @@ void fixed_user_defined_types()
     std::cout << std::scientific << std::setprecision(16) << njs3::json_out_pretty << DEBUG_OUTPUT(json_from_matrix3x3f);
 }
 
+//  ### 🌟 Reading JSON Into User Defined Types With `parse_into`
+//  👇 `parse_into<T>` reads `T` directly from the tokens (see `json_cursor`), without making `json` values.
+//  Give your type `json_fields`, binding object member names to data members. Unknown members are skipped.
+struct order_line
+{
+    std::string sku{};
+    int quantity{};
+
+    static constexpr auto json_fields = std::make_tuple(
+        njs3::json_field("sku", &order_line::sku),
+        njs3::json_field("qty", &order_line::quantity));
+};
+
+struct order
+{
+    int64_t id{};
+    std::vector<order_line> lines{};
+    std::optional<std::string> note{};
+
+    static constexpr auto json_fields = std::make_tuple(
+        njs3::json_field("id", &order::id),
+        njs3::json_field("lines", &order::lines),
+        njs3::json_field("note", &order::note));
+};
+
+void reading_user_defined_types()
+{
+    auto src = R"({"id": 7, "lines": [{"sku": "A-1", "qty": 2}, {"sku": "B-2", "qty": 1}], "note": null, "audit": {"by": "x"}})";
+    const order o = njs3::parse_into<order>(src);
+    std::cout << DEBUG_OUTPUT(o.id);              // 7
+    std::cout << DEBUG_OUTPUT(o.lines[1].sku);    // B-2
+    std::cout << DEBUG_OUTPUT(o.note.has_value()); // false
+
+    // reading into a reused struct resets the members missing from the document. (the capacity of strings and containers is kept)
+    order reused = o;
+    njs3::parse_into(R"({"id": 8, "note": "rush"})", reused);
+    std::cout << DEBUG_OUTPUT(reused.lines.size()); // 0
+    std::cout << DEBUG_OUTPUT(*reused.note);        // rush
+
+    // STL containers and scalars are readable too. `parse_into(src, target)` reuses the capacity of `target`.
+    std::map<std::string, std::vector<int>> m{};
+    njs3::parse_into(R"({"a": [1, 2], "b": []})", m);
+    std::cout << DEBUG_OUTPUT(m["a"].size()); // 2
+
+    // duplicate keys are treated as `json_parse_option` specifies, for members of structs and keys of maps. (by default the last value wins)
+    auto dup = R"({"id": 1, "id": 2})";
+    std::cout << DEBUG_OUTPUT(njs3::parse_into<order>(dup, njs3::json_parse_option::keep_first_duplicate_key).id); // 1
+    try { (void)njs3::parse_into<std::map<std::string, int>>(dup, njs3::json_parse_option::reject_duplicate_key); }
+    catch (const njs3::bad_format& e) { std::cout << e.what() << std::endl; } // duplicate key "id" at offset 10
+}
+
 //  ### 🌟 EOF
 //  😃 Have fun.
 